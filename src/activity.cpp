@@ -0,0 +1,81 @@
+#include <vector>
+
+#include "activity.h"
+#include "game.h"
+#include "settings.h"
+
+static bool activity_is_resting(const Entity& e) {
+    switch (e.type) {
+        case Entity_Type::Player: return false;
+
+        case Entity_Type::Enemy: {
+            // only idle ones, one that falls asleep in the middle of doing something stays frozen like that
+            if (e.extra_enemy.slot != SLOT_NONE) return false;
+            if (e.x_vel != 0.0f || e.y_vel != 0.0f) return false;
+            switch (e.extra_enemy.state) {
+                case Enemy_State::Standing:
+                case Enemy_State::Guarding: return true;
+                default:                    return false;
+            }
+        }
+
+        case Entity_Type::Barrel: {
+            return e.extra_barrel.state == Barrel_State::Idle;
+        }
+
+        case Entity_Type::Collectible: {
+            return e.extra_collectible.state == Collectible_State::On_The_Ground && !e.extra_collectible.picked_up;
+        }
+    }
+
+    return false;
+}
+
+static bool activity_is_near_camera(const Entity& e, const Game& g) {
+    const f32 margin = settings.sleep_camera_margin;
+    return e.x >= g.camera.x - margin && e.x <= g.camera.x + g.camera.w + margin;
+}
+
+struct Activity_Actor {
+    Vec2<f32> pos;
+    f32       reach_sq; // the wake distance plus how far the actor can still move this tick
+};
+
+static bool activity_prop_sleeps(const Entity& e, const Game& g, const std::vector<Activity_Actor>& actors) {
+    if (!e.damage_queue.empty() || !activity_is_resting(e)) return false;
+    if (!activity_is_near_camera(e, g))                      return true;
+
+    for (const auto& actor : actors) {
+        const f32 dx = actor.pos.x - e.x;
+        const f32 dy = actor.pos.y - e.y;
+        if (dx*dx + dy*dy <= actor.reach_sq) return false;
+    }
+    return true;
+}
+
+void activity_update(Game& g) {
+    // whatever can walk up to a prop and wake it, kept around between frames
+    static std::vector<Activity_Actor> actors;
+    actors.clear();
+
+    // actors first, the props depend on them
+    for (auto& e : g.entities) {
+        if (e.type != Entity_Type::Player && e.type != Entity_Type::Enemy) continue;
+
+        e.sleeping = e.damage_queue.empty() && activity_is_resting(e) && !activity_is_near_camera(e, g);
+        animation_set_paused(e.anim, e.sleeping);
+        if (e.sleeping) continue;
+
+        // this runs before the movement of the tick, a fast actor could pass a prop within a single one
+        const f32 travel = Vec2<f32>{e.x_vel, e.y_vel}.len() * g.dt;
+        const f32 reach  = settings.sleep_wake_distance + travel;
+        actors.push_back({entity_get_pos(e), reach * reach});
+    }
+
+    for (auto& e : g.entities) {
+        if (e.type != Entity_Type::Barrel && e.type != Entity_Type::Collectible) continue;
+
+        e.sleeping = activity_prop_sleeps(e, g, actors);
+        animation_set_paused(e.anim, e.sleeping);
+    }
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+struct Game;
+
+// Puts resting entities to sleep and wakes them back up, has to be called at the start
+// of every update, before anything looks at Entity::sleeping.
+//
+// Resting means idle barrels, collectibles lying on the ground and enemies that are
+// standing still without a claimed slot. A resting entity sleeps when it is further
+// than settings.sleep_camera_margin outside of the camera. Resting props also sleep
+// on screen until the player or an awake enemy is within settings.sleep_wake_distance,
+// padded by how far that actor moves in this tick. Anything with queued damage or that
+// was picked up is always awake, and so is the player.
+void activity_update(Game& g);
@@ -0,0 +1,62 @@
+// Replaces the global operator new/delete so that every heap allocation made through them
+// shows up in the perf counters. Only compiled in with the FOF_TRACK_ALLOCATIONS cmake option.
+//
+// The counters arent atomic, everything that allocates through new runs on the main thread
+// (the asset loader workers only allocate through SDL_image).
+
+#ifdef FOF_TRACK_ALLOCATIONS
+
+#include <new>
+
+#include <SDL3/SDL.h>
+
+#include "perf.h"
+
+static void* alloc_tracked(std::size_t size) {
+    perf_count_alloc(size);
+    // malloc(0) is allowed to return null, new has to return a unique pointer
+    void* ptr = SDL_malloc(size > 0 ? size : 1);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+static void* alloc_tracked_aligned(std::size_t size, std::align_val_t align) {
+    perf_count_alloc(size);
+    void* ptr = SDL_aligned_alloc((std::size_t)align, size > 0 ? size : 1);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new(std::size_t size)   { return alloc_tracked(size); }
+void* operator new[](std::size_t size) { return alloc_tracked(size); }
+void* operator new(std::size_t size, std::align_val_t align)   { return alloc_tracked_aligned(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return alloc_tracked_aligned(size, align); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try { return alloc_tracked(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try { return alloc_tracked(size); } catch (...) { return nullptr; }
+}
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    try { return alloc_tracked_aligned(size, align); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    try { return alloc_tracked_aligned(size, align); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* ptr) noexcept                           { SDL_free(ptr); }
+void operator delete[](void* ptr) noexcept                         { SDL_free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept              { SDL_free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept            { SDL_free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept    { SDL_free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept  { SDL_free(ptr); }
+
+void operator delete(void* ptr, std::align_val_t) noexcept                              { SDL_aligned_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept                            { SDL_aligned_free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept                 { SDL_aligned_free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept               { SDL_aligned_free(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept       { SDL_aligned_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept     { SDL_aligned_free(ptr); }
+
+#endif
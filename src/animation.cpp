@@ -1,103 +1,326 @@
+#include <bit>
 #include <cassert>
 #include <cmath>
 
 #include "animation.h"
 
-void animation_start(Animation& a, Anim_Start_Opts opts) {
-    assert(a.sprite != nullptr);
+Animation_System animations;
+
+static u32 frame_slot_alloc(Anim_Frame_Slots& f) {
+    if (!f.free.empty()) {
+        const u32 slot = f.free.back();
+        f.free.pop_back();
+        return slot;
+    }
+
+    f.timer_ms.push_back(0.0f);
+    f.duration_ms.push_back(0.0f);
+    f.frame_current.push_back(0);
+    f.frame_count.push_back(0);
+    f.frames_looping.push_back(0);
+    f.any_looping.push_back(0);
+    f.in_use.push_back(0);
+    f.dt_scale.push_back(0.0f);
+    f.finished.push_back(0);
+    return (u32)f.timer_ms.size() - 1;
+}
+
+static u32 fadeout_slot_alloc(Anim_Fadeout_Slots& f) {
+    if (!f.free.empty()) {
+        const u32 slot = f.free.back();
+        f.free.pop_back();
+        return slot;
+    }
 
-    a.frames.idx           = opts.anim_idx;
-    a.frames.frame_current = 0;
-    a.frames.frame_count   = a.sprite->frames_in_each_row[opts.anim_idx];
-    a.frames.looping       = opts.looping;
-    a.frame_duration_ms    = opts.frame_duration_ms;
-    a.accumulated_time_ms  = 0;
-    a.fadeout              = opts.fadeout;
-    a.rotation             = opts.rotation;
+    f.perc_curr.push_back(0.0f);
+    f.perc_per_sec.push_back(0.0f);
+    f.perc_start.push_back(0.0f);
+    f.perc_end.push_back(0.0f);
+    f.looping.push_back(0);
+    f.in_use.push_back(0);
+    f.owner.push_back(0);
+    f.dt_scale.push_back(0.0f);
+    return (u32)f.perc_curr.size() - 1;
 }
 
-static bool fadeout_finished(const Fadeout& f) {
-    if (!f.enabled) return true;
-    return f.perc_visible_curr <= f.perc_visible_end;
+static u32 rotation_slot_alloc(Anim_Rotation_Slots& r) {
+    if (!r.free.empty()) {
+        const u32 slot = r.free.back();
+        r.free.pop_back();
+        return slot;
+    }
+
+    r.deg_curr.push_back(0.0f);
+    r.deg_per_sec.push_back(0.0f);
+    r.deg_start.push_back(0.0f);
+    r.rotations_curr.push_back(0);
+    r.rotations_min.push_back(0);
+    r.finish_ranges.push_back({});
+    r.finish_range_count.push_back(0);
+    r.looping.push_back(0);
+    r.in_use.push_back(0);
+    r.owner.push_back(0);
+    r.dt_scale.push_back(0.0f);
+    return (u32)r.deg_curr.size() - 1;
 }
 
-static bool deg_in_range(f32 deg, const Rotation_Range& range) {
-    f32 abs_deg = std::abs(deg);
-    return abs_deg >= range.start && abs_deg <= range.end;
+static void fadeout_slot_free(Anim_Fadeout_Slots& f, u32& slot) {
+    if (slot == ANIMATION_SLOT_NONE) return;
+    f.in_use[slot]   = 0;
+    f.dt_scale[slot] = 0.0f;
+    f.free.push_back(slot);
+    slot = ANIMATION_SLOT_NONE;
 }
 
-static bool rotation_finished(const Rotation& r) {
-    if (!r.enabled) return true;
-    if (r.rotations_curr <= r.rotations_min) return false;
+static void rotation_slot_free(Anim_Rotation_Slots& r, u32& slot) {
+    if (slot == ANIMATION_SLOT_NONE) return;
+    r.in_use[slot]   = 0;
+    r.dt_scale[slot] = 0.0f;
+    r.free.push_back(slot);
+    slot = ANIMATION_SLOT_NONE;
+}
+
+// The checks below are shared by animation_start and the batched loops, none of them branch.
+
+static bool frames_done(f32 timer_ms, f32 duration_ms, u32 frame_current, u32 frame_count) {
+    // single frame animations are done once their duration has passed
+    const bool single = frame_count == 1;
+    return (single & (timer_ms >= duration_ms)) | (!single & (frame_current >= frame_count - 1));
+}
 
-    f32 deg = std::fmod(r.deg_curr, 360);
-    for (const auto& range : r.finish_ranges) {
-        if (deg_in_range(deg, range)) return true;
+static bool fadeout_done(f32 perc_curr, f32 perc_end) {
+    return perc_curr <= perc_end;
+}
+
+// |deg| wrapped into a single turn, the same as std::abs(std::fmod(deg, 360)) without the fmod
+static f32 rotation_deg_in_turn(f32 deg) {
+    const f32 abs_deg = std::abs(deg);
+    return abs_deg - 360.0f * std::floor(abs_deg / 360.0f);
+}
+
+static bool rotation_done(const Anim_Rotation_Slots& r, u32 slot) {
+    assert(r.finish_range_count[slot] <= ROTATION_FINISH_RANGES_MAX);
+    const f32 deg = rotation_deg_in_turn(r.deg_curr[slot]);
+
+    bool in_range = false;
+    for (u32 idx = 0; idx < ROTATION_FINISH_RANGES_MAX; idx++) {
+        const auto& range = r.finish_ranges[slot][idx];
+        in_range |= (idx < r.finish_range_count[slot]) & (deg >= range.start) & (deg <= range.end);
     }
+    return (r.rotations_curr[slot] > r.rotations_min[slot]) & in_range;
+}
 
-    return false;
+static void finished_bit_set(Animation_System& s, u32 slot, bool finished) {
+    const usize word = slot / 64;
+    if (word >= s.finished.size()) s.finished.resize(word + 1, 0);
+    const u64 bit = 1ull << (slot % 64);
+    s.finished[word] = finished ? s.finished[word] | bit : s.finished[word] & ~bit;
 }
 
-static bool any_looping(const Animation& a) {
-    return a.looping
-        || a.frames.looping
-        || a.fadeout.looping
-        || a.rotation.looping;
+static bool animation_compute_finished(const Animation_System& s, const Animation& a) {
+    const auto& f = s.frames;
+    bool done = !f.any_looping[a.slot] && frames_done(f.timer_ms[a.slot], f.duration_ms[a.slot], f.frame_current[a.slot], f.frame_count[a.slot]);
+    if (a.slot_fadeout  != ANIMATION_SLOT_NONE) done &= fadeout_done(s.fadeouts.perc_curr[a.slot_fadeout], s.fadeouts.perc_end[a.slot_fadeout]);
+    if (a.slot_rotation != ANIMATION_SLOT_NONE) done &= rotation_done(s.rotations, a.slot_rotation);
+    return done;
 }
 
-bool animation_is_finished(const Animation& a) {
+void animation_start(Animation& a, Anim_Start_Opts opts) {
     assert(a.sprite != nullptr);
+    auto& s = animations;
+
+    // a new slot starts out running, a reused one keeps whether its entity sleeps
+    if (a.slot == ANIMATION_SLOT_NONE) {
+        a.slot = frame_slot_alloc(s.frames);
+        s.frames.dt_scale[a.slot] = 1.0f;
+    }
+    const f32 dt_scale = s.frames.dt_scale[a.slot];
 
-    if (any_looping(a)) return false;
-    if (!fadeout_finished(a.fadeout)) return false;
-    if (!rotation_finished(a.rotation)) return false;
+    auto& f = s.frames;
+    f.timer_ms[a.slot]       = 0.0f;
+    f.duration_ms[a.slot]    = (f32)opts.frame_duration_ms;
+    f.frame_current[a.slot]  = 0;
+    f.frame_count[a.slot]    = a.sprite->frames_in_each_row[opts.anim_idx];
+    f.frames_looping[a.slot] = opts.looping;
+    f.any_looping[a.slot]    = opts.looping || opts.fadeout.looping || opts.rotation.looping;
+    f.in_use[a.slot]         = 1;
 
-    // For single-frame animations, check if enough time has passed
-    if (a.frames.frame_count == 1) {
-        return a.accumulated_time_ms >= a.frame_duration_ms;
+    a.opacity_static = opts.fadeout.perc_visible_curr;
+    if (opts.fadeout.enabled) {
+        if (a.slot_fadeout == ANIMATION_SLOT_NONE) a.slot_fadeout = fadeout_slot_alloc(s.fadeouts);
+        auto& fo = s.fadeouts;
+        const u32 slot = a.slot_fadeout;
+        fo.perc_curr[slot]    = opts.fadeout.perc_visible_curr;
+        fo.perc_per_sec[slot] = opts.fadeout.perc_per_sec;
+        fo.perc_start[slot]   = opts.fadeout.perc_visible_start;
+        fo.perc_end[slot]     = opts.fadeout.perc_visible_end;
+        fo.looping[slot]      = opts.fadeout.looping;
+        fo.in_use[slot]       = 1;
+        fo.owner[slot]        = a.slot;
+        fo.dt_scale[slot]     = dt_scale;
+    } else {
+        fadeout_slot_free(s.fadeouts, a.slot_fadeout);
     }
 
-    return a.frames.frame_current >= a.frames.frame_count - 1;
+    a.deg_static = opts.rotation.deg_curr;
+    if (opts.rotation.enabled) {
+        if (a.slot_rotation == ANIMATION_SLOT_NONE) a.slot_rotation = rotation_slot_alloc(s.rotations);
+        auto& r = s.rotations;
+        const u32 slot = a.slot_rotation;
+        r.deg_curr[slot]           = opts.rotation.deg_curr;
+        r.deg_per_sec[slot]        = opts.rotation.deg_per_sec;
+        r.deg_start[slot]          = opts.rotation.deg_start;
+        r.rotations_curr[slot]     = opts.rotation.rotations_curr;
+        r.rotations_min[slot]      = opts.rotation.rotations_min;
+        r.finish_ranges[slot]      = opts.rotation.finish_ranges;
+        r.finish_range_count[slot] = opts.rotation.finish_range_count;
+        r.looping[slot]            = opts.rotation.looping;
+        r.in_use[slot]             = 1;
+        r.owner[slot]              = a.slot;
+        r.dt_scale[slot]           = dt_scale;
+    } else {
+        rotation_slot_free(s.rotations, a.slot_rotation);
+    }
+
+    a.row  = opts.anim_idx;
+    a.clip = CLIP_NONE;
+    finished_bit_set(s, a.slot, animation_compute_finished(s, a));
+}
+
+void animation_play(Animation& a, Clip_Id id) {
+    assert(a.sprite != nullptr);
+    const auto& c = clip_get(id);
+    // catches a clip being played on the wrong kind of sheet (boss clips on a regular enemy)
+    assert(a.sprite->frames_in_each_row[c.anim_idx] == c.frame_count);
+
+    animation_start(a, {
+        .anim_idx          = c.anim_idx,
+        .frame_duration_ms = c.frame_duration_ms,
+        .fadeout           = { .enabled = c.fadeout_perc_per_sec > 0.0f, .perc_per_sec = c.fadeout_perc_per_sec },
+        .looping           = c.looping,
+    });
+    a.clip = id;
+}
+
+void animation_release(Animation& a) {
+    auto& s = animations;
+    fadeout_slot_free(s.fadeouts, a.slot_fadeout);
+    rotation_slot_free(s.rotations, a.slot_rotation);
+    if (a.slot == ANIMATION_SLOT_NONE) return;
+
+    s.frames.in_use[a.slot]   = 0;
+    s.frames.dt_scale[a.slot] = 0.0f;
+    s.frames.free.push_back(a.slot);
+    finished_bit_set(s, a.slot, false);
+    a.slot = ANIMATION_SLOT_NONE;
+}
+
+void animation_set_paused(const Animation& a, bool paused) {
+    if (a.slot == ANIMATION_SLOT_NONE) return;
+    auto& s = animations;
+    const f32 dt_scale = paused ? 0.0f : 1.0f;
+    s.frames.dt_scale[a.slot] = dt_scale;
+    if (a.slot_fadeout  != ANIMATION_SLOT_NONE) s.fadeouts.dt_scale[a.slot_fadeout]   = dt_scale;
+    if (a.slot_rotation != ANIMATION_SLOT_NONE) s.rotations.dt_scale[a.slot_rotation] = dt_scale;
 }
 
-void animation_update(Animation& a, u64 dt, u64 real_dt) {
+bool animation_is_finished(const Animation& a) {
     assert(a.sprite != nullptr);
+    if (a.slot == ANIMATION_SLOT_NONE) return false;
+    return (animations.finished[a.slot / 64] >> (a.slot % 64)) & 1;
+}
 
-    a.accumulated_time_ms += dt;
+u32 animation_frame(const Animation& a) {
+    if (a.slot == ANIMATION_SLOT_NONE) return 0;
+    return animations.frames.frame_current[a.slot];
+}
 
-    if (a.accumulated_time_ms >= a.frame_duration_ms && a.frames.frame_count != 1) {
-        a.frames.frame_current++;
-        a.accumulated_time_ms -= a.frame_duration_ms;
+f32 animation_opacity(const Animation& a) {
+    if (a.slot_fadeout == ANIMATION_SLOT_NONE) return a.opacity_static;
+    return animations.fadeouts.perc_curr[a.slot_fadeout];
+}
+
+f32 animation_rotation_deg(const Animation& a) {
+    if (a.slot_rotation == ANIMATION_SLOT_NONE) return a.deg_static;
+    return animations.rotations.deg_curr[a.slot_rotation];
+}
 
-        // Check if sprite animation finished
-        if (a.frames.frame_current >= a.frames.frame_count) {
-            if (a.frames.looping) {
-                a.frames.frame_current = 0; // Loop back to start
-            } else {
-                // loop the last frame until we start another animation
-                a.frames.frame_current -= 1;
-            }
-        }
+Rotation animation_rotation(const Animation& a) {
+    if (a.slot_rotation == ANIMATION_SLOT_NONE) return {.enabled = false, .deg_curr = a.deg_static};
 
+    const auto& r    = animations.rotations;
+    const u32   slot = a.slot_rotation;
+    return {
+        .enabled            = true,
+        .looping            = r.looping[slot] != 0,
+        .finish_ranges      = r.finish_ranges[slot],
+        .finish_range_count = r.finish_range_count[slot],
+        .deg_per_sec        = r.deg_per_sec[slot],
+        .deg_curr           = r.deg_curr[slot],
+        .deg_start          = r.deg_start[slot],
+        .rotations_min      = r.rotations_min[slot],
+        .rotations_curr     = r.rotations_curr[slot],
+    };
+}
+
+static void advance_frames(Anim_Frame_Slots& f, f32 dt) {
+    const usize count = f.timer_ms.size();
+    for (usize idx = 0; idx < count; idx++) {
+        const f32  timer = f.timer_ms[idx] + dt * f.dt_scale[idx];
+        // at most one frame per update, paused and free slots dont step
+        const bool step  = (timer >= f.duration_ms[idx]) & (f.frame_count[idx] != 1) & (f.dt_scale[idx] > 0.0f);
+
+        const u32 frame     = f.frame_current[idx] + step;
+        const u32 frame_end = f.frames_looping[idx] ? 0 : f.frame_count[idx] - 1; // loop back or hold the last one
+        f.frame_current[idx] = frame >= f.frame_count[idx] ? frame_end : frame;
+        f.timer_ms[idx]      = timer - step * f.duration_ms[idx];
     }
+}
+
+static void advance_fadeouts(Anim_Fadeout_Slots& f, f32 dt_real) {
+    const usize count = f.perc_curr.size();
+    for (usize idx = 0; idx < count; idx++) {
+        const f32  perc  = f.perc_curr[idx] - f.perc_per_sec[idx] * dt_real / 1000.0f * f.dt_scale[idx];
+        const bool faded = perc <= f.perc_end[idx];
+        const f32  reset = f.looping[idx] ? f.perc_start[idx] : 0.0f;
+        f.perc_curr[idx] = faded ? reset : perc;
+    }
+}
 
-    if (a.fadeout.enabled) {
-        // current_time - a.last_frame_time = dt (ms)
-        // dt (s) = dt / 1000
-        // a.fadeout.perc_per_sec*dt
-        const auto perc_to_fade = a.fadeout.perc_per_sec * real_dt / 1000.0f;
-        a.fadeout.perc_visible_curr -= perc_to_fade;
-        const auto faded = a.fadeout.perc_visible_curr <= a.fadeout.perc_visible_end;
-
-        if (a.fadeout.looping && faded) {
-            a.fadeout.perc_visible_curr = a.fadeout.perc_visible_start;
-        } else if (faded) {
-            a.fadeout.perc_visible_curr = 0.0f;
-        }
+static void advance_rotations(Anim_Rotation_Slots& r, f32 dt) {
+    const usize count = r.deg_curr.size();
+    for (usize idx = 0; idx < count; idx++) {
+        r.deg_curr[idx]      += r.deg_per_sec[idx] * dt / 1000.0f * r.dt_scale[idx];
+        r.rotations_curr[idx] = (u32)((r.deg_curr[idx] - r.deg_start[idx]) / 360.0f);
+    }
+}
+
+void animation_system_update(Animation_System& s, u64 dt, u64 dt_real) {
+    advance_frames(s.frames, (f32)dt);
+    advance_fadeouts(s.fadeouts, (f32)dt_real);
+    advance_rotations(s.rotations, (f32)dt);
+
+    // finished unless a feature of the same animation isnt done yet
+    auto& f = s.frames;
+    const usize count = f.timer_ms.size();
+    for (usize idx = 0; idx < count; idx++) {
+        f.finished[idx] = f.in_use[idx] & !f.any_looping[idx] & frames_done(f.timer_ms[idx], f.duration_ms[idx], f.frame_current[idx], f.frame_count[idx]);
+    }
+    const auto& fo = s.fadeouts;
+    for (usize idx = 0; idx < fo.perc_curr.size(); idx++) {
+        f.finished[fo.owner[idx]] &= !fo.in_use[idx] | fadeout_done(fo.perc_curr[idx], fo.perc_end[idx]);
+    }
+    const auto& r = s.rotations;
+    for (usize idx = 0; idx < r.deg_curr.size(); idx++) {
+        f.finished[r.owner[idx]] &= !r.in_use[idx] | rotation_done(r, idx);
     }
 
-    if (a.rotation.enabled) {
-        a.rotation.deg_curr += a.rotation.deg_per_sec * dt / 1000.0f;
-        a.rotation.rotations_curr = (u32)((a.rotation.deg_curr - a.rotation.deg_start) / 360.0f);
+    s.finished.assign((count + 63) / 64, 0);
+    s.count_active   = 0;
+    s.count_finished = 0;
+    for (usize idx = 0; idx < count; idx++) {
+        s.finished[idx / 64] |= (u64)f.finished[idx] << (idx % 64);
+        s.count_active       += f.in_use[idx] & (f.dt_scale[idx] > 0.0f);
     }
+    for (const u64 word : s.finished) s.count_finished += std::popcount(word);
 }
@@ -1,26 +1,15 @@
 #pragma once
 
+#include <array>
+#include <type_traits>
 #include <vector>
 
 #include <SDL3/SDL.h>
 
+#include "clips.h"
 #include "number_types.h"
 #include "sprite.h"
 
-struct Sprite_Frames {
-    // idx of the animation (row in the sprite)
-    u32 idx;
-
-    // Current frame in the animation (col in the sprite)
-    u32 frame_current;
-
-    // Max frames for this animation before it is finished or it loops
-    u32 frame_count;
-
-    // Whether this animation should loop
-    bool looping;
-};
-
 struct Fadeout {
     bool enabled            = false;
     bool looping            = false;
@@ -35,34 +24,48 @@ struct Fadeout {
 // value of the deg_curr
 struct Rotation_Range { f32 start, end; };
 
+const u32 ROTATION_FINISH_RANGES_MAX = 4;
+// inline so that Animation stays trivially copyable
+using Rotation_Ranges = std::array<Rotation_Range, ROTATION_FINISH_RANGES_MAX>;
+
 struct Rotation {
-    bool                        enabled        = false;
-    bool                        looping        = false;
-    std::vector<Rotation_Range> finish_ranges  = {};
-    f32                         deg_per_sec    = 30.0f;
-    f32                         deg_curr       = 0.0f;
-    f32                         deg_start      = 0.0f;
-    u32                         rotations_min  = 1;
-    u32                         rotations_curr = 0;
+    bool            enabled            = false;
+    bool            looping            = false;
+    // only the first finish_range_count are used
+    Rotation_Ranges finish_ranges      = {};
+    u32             finish_range_count = 0;
+    f32             deg_per_sec        = 30.0f;
+    f32             deg_curr           = 0.0f;
+    f32             deg_start          = 0.0f;
+    u32             rotations_min      = 1;
+    u32             rotations_curr     = 0;
 };
 
+const u32 ANIMATION_SLOT_NONE = UINT32_MAX;
+
+// What is playing, the state that changes every frame lives in the slots of the animation system.
+// The slots belong to the entity until animation_release, copying the entity moves them along.
 struct Animation {
     // sprite that will be animated
     const Sprite* sprite;
 
-    f32 accumulated_time_ms;
-
-    // Milliseconds per frame
-    u64 frame_duration_ms;
-    
-    // this overrides all of the underyling looping variables for all systems
-    // if set to true, otherwise the underyling systems choose if they loop
-    bool          looping = false;
-    Sprite_Frames frames;
-    Fadeout       fadeout;
-    Rotation      rotation;
+    // idx of the animation (row in the sprite)
+    u32     row;
+    // which clip of the clip table is playing, for looking up its boxes
+    Clip_Id clip = CLIP_NONE;
+
+    u32 slot          = ANIMATION_SLOT_NONE; // frames, every started animation has one
+    u32 slot_fadeout  = ANIMATION_SLOT_NONE; // only while the fadeout is enabled
+    u32 slot_rotation = ANIMATION_SLOT_NONE; // only while the rotation is enabled
+
+    // what gets drawn without a fadeout or a rotation slot
+    f32 opacity_static = 1.0f;
+    f32 deg_static     = 0.0f;
 };
 
+// copied around with every Entity, so it must not own any memory
+static_assert(std::is_trivially_copyable_v<Animation>);
+
 struct Anim_Start_Opts {
     u32      anim_idx;
     u64      frame_duration_ms = 100;
@@ -72,5 +75,79 @@ struct Anim_Start_Opts {
 };
 
 void animation_start(Animation& a, Anim_Start_Opts opts);
-void animation_update(Animation& a, u64 dt, u64 real_dt);
-bool animation_is_finished(const Animation& a);
+// Starts a clip from the clip table (clips.def), prefer this over building Anim_Start_Opts.
+void animation_play(Animation& a, Clip_Id id);
+// frees the slots, for entities that get despawned
+void animation_release(Animation& a);
+// sleeping entities keep their animation where it is
+void animation_set_paused(const Animation& a, bool paused);
+
+// Result of the last animation_system_update (or of animation_start if it was started after it).
+bool     animation_is_finished(const Animation& a);
+u32      animation_frame(const Animation& a);
+f32      animation_opacity(const Animation& a);
+f32      animation_rotation_deg(const Animation& a);
+// the rotation as it is right now, to carry it over into the next animation
+Rotation animation_rotation(const Animation& a);
+
+// Every array is indexed by slot. Freed slots stay in place with a dt scale of 0 and get reused,
+// so the loops over them dont need to branch on whether a slot is in use.
+struct Anim_Frame_Slots {
+    std::vector<f32> timer_ms;
+    std::vector<f32> duration_ms;
+    std::vector<u32> frame_current;
+    std::vector<u32> frame_count;
+    std::vector<u8>  frames_looping;
+    std::vector<u8>  any_looping; // of any feature, those never finish
+    std::vector<u8>  in_use;
+    std::vector<f32> dt_scale;    // 0 while free or paused, 1 otherwise
+    std::vector<u8>  finished;    // scratch for building the bitset
+    std::vector<u32> free;
+};
+
+struct Anim_Fadeout_Slots {
+    std::vector<f32> perc_curr;
+    std::vector<f32> perc_per_sec;
+    std::vector<f32> perc_start;
+    std::vector<f32> perc_end;
+    std::vector<u8>  looping;
+    std::vector<u8>  in_use;
+    std::vector<u32> owner; // frame slot
+    std::vector<f32> dt_scale;
+    std::vector<u32> free;
+};
+
+struct Anim_Rotation_Slots {
+    std::vector<f32>             deg_curr;
+    std::vector<f32>             deg_per_sec;
+    std::vector<f32>             deg_start;
+    std::vector<u32>             rotations_curr;
+    std::vector<u32>             rotations_min;
+    std::vector<Rotation_Ranges> finish_ranges;
+    std::vector<u32>             finish_range_count;
+    std::vector<u8>              looping;
+    std::vector<u8>              in_use;
+    std::vector<u32>             owner; // frame slot
+    std::vector<f32>             dt_scale;
+    std::vector<u32>             free;
+};
+
+// The state of every animation in structure of arrays form, grouped by feature, and advanced for all
+// of them in one pass per frame instead of every state machine doing it on its own.
+struct Animation_System {
+    Anim_Frame_Slots    frames;
+    Anim_Fadeout_Slots  fadeouts;
+    Anim_Rotation_Slots rotations;
+    // a bit per frame slot, what animation_is_finished reads
+    std::vector<u64>    finished;
+
+    // for the debug menu
+    u32 count_active;
+    u32 count_finished;
+};
+
+// Global like asset_pack, the hitboxes of the entities depend on the frame and get looked up without a Game.
+extern Animation_System animations;
+
+// Has to run at the start of the frame, before the state machines read animation_is_finished.
+void animation_system_update(Animation_System& s, u64 dt, u64 dt_real);
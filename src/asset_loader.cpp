@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+
+#include <SDL3_image/SDL_image.h>
+
+#include "asset_loader.h"
+
+void asset_loader_add_img(Asset_Loader& l, Img& i, const char* path) {
+    assert(l.job_count < ASSET_LOADER_CAPACITY);
+    assert(l.worker_count == 0 && "add every image before starting");
+
+    auto& job = l.jobs[l.job_count++];
+    job       = {};
+    job.path  = path;
+    job.img   = &i;
+    // nothing to decode, the pixels get uploaded straight from the pack
+    job.done  = img_is_in_asset_pack(path);
+}
+
+void asset_loader_add_sprite(Asset_Loader& l, Sprite& s, const char* path) {
+    assert(s.max_frames_in_row_count   > 0);
+    assert(s.frames_in_each_row.size() > 0);
+
+    asset_loader_add_img(l, s.img, path);
+}
+
+// SDL_image only allocates through SDL_malloc, nothing here goes through the tracked operator new
+static void asset_job_decode(Asset_Job& job) {
+    job.surface = IMG_Load(job.path);
+    if (!job.surface) std::snprintf(job.error, sizeof(job.error), "%s", SDL_GetError());
+}
+
+static int asset_loader_worker(void* data) {
+    auto& l = *(Asset_Loader*)data;
+
+    while (true) {
+        SDL_LockMutex(l.mutex);
+        while (l.idx_next_job < l.job_count && l.jobs[l.idx_next_job].done) l.idx_next_job++;
+        if (l.idx_next_job == l.job_count) {
+            SDL_UnlockMutex(l.mutex);
+            return 0;
+        }
+        auto& job = l.jobs[l.idx_next_job++];
+        SDL_UnlockMutex(l.mutex);
+
+        asset_job_decode(job);
+
+        SDL_LockMutex(l.mutex);
+        job.done = true;
+        SDL_BroadcastCondition(l.job_done);
+        SDL_UnlockMutex(l.mutex);
+    }
+}
+
+void asset_loader_start(Asset_Loader& l) {
+    u32 decode_count = 0;
+    for (u32 idx = 0; idx < l.job_count; idx++) {
+        if (!l.jobs[idx].done) decode_count++;
+    }
+    if (decode_count == 0) return;
+
+    l.mutex    = SDL_CreateMutex();
+    l.job_done = SDL_CreateCondition();
+    if (!l.mutex || !l.job_done) {
+        SDL_Log("Could not create the asset loader sync, decoding on the main thread! SDL err: %s\n", SDL_GetError());
+        return;
+    }
+
+    const u32 cores        = (u32)std::max(1, SDL_GetNumLogicalCPUCores());
+    const u32 worker_count = std::min({cores, decode_count, ASSET_LOADER_MAX_WORKERS});
+    for (u32 idx = 0; idx < worker_count; idx++) {
+        SDL_Thread* thread = SDL_CreateThread(asset_loader_worker, "asset_loader", &l);
+        if (!thread) {
+            SDL_Log("Could not create an asset loader worker! SDL err: %s\n", SDL_GetError());
+            break;
+        }
+        l.workers[l.worker_count++] = thread;
+    }
+}
+
+// blocks until a worker is done with the job, or decodes it right here when there are no workers
+static void asset_loader_wait_for(Asset_Loader& l, Asset_Job& job) {
+    if (l.worker_count == 0) {
+        if (!job.done) asset_job_decode(job);
+        job.done = true;
+        return;
+    }
+
+    SDL_LockMutex(l.mutex);
+    while (!job.done) SDL_WaitCondition(l.job_done, l.mutex);
+    SDL_UnlockMutex(l.mutex);
+}
+
+static void asset_loader_join(Asset_Loader& l) {
+    for (u32 idx = 0; idx < l.worker_count; idx++) SDL_WaitThread(l.workers[idx], nullptr);
+    l.worker_count = 0;
+    if (l.job_done) SDL_DestroyCondition(l.job_done);
+    if (l.mutex)    SDL_DestroyMutex(l.mutex);
+    l.job_done = nullptr;
+    l.mutex    = nullptr;
+}
+
+bool asset_loader_finish(Asset_Loader& l, SDL_Renderer* r, Asset_Progress_Fn progress, void* user) {
+    bool all_ok = true;
+
+    // in the order they were added, the workers take them in the same order so the wait is short
+    for (u32 idx = 0; idx < l.job_count; idx++) {
+        auto& job = l.jobs[idx];
+        asset_loader_wait_for(l, job);
+
+        bool ok;
+        if (job.surface) {
+            ok = img_load_from_surface(*job.img, r, job.surface);
+            SDL_DestroySurface(job.surface);
+            job.surface = nullptr;
+        } else if (job.error[0] != '\0') {
+            SDL_Log("Could not decode %s! SDL err: %s\n", job.path, job.error);
+            ok = false;
+        } else {
+            ok = img_load(*job.img, r, job.path);
+        }
+        if (!ok) {
+            SDL_Log("Failed to load %s!\n", job.path);
+            all_ok = false;
+        }
+
+        if (progress) progress(idx + 1, l.job_count, user);
+    }
+
+    asset_loader_join(l);
+    return all_ok;
+}
+
+void asset_loader_cancel(Asset_Loader& l) {
+    // the workers finish the image they are on and then find nothing left to take
+    SDL_LockMutex(l.mutex);
+    l.idx_next_job = l.job_count;
+    SDL_UnlockMutex(l.mutex);
+    asset_loader_join(l);
+
+    for (u32 idx = 0; idx < l.job_count; idx++) {
+        auto& job = l.jobs[idx];
+        if (job.surface) SDL_DestroySurface(job.surface);
+        job.surface = nullptr;
+    }
+}
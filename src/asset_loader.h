@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <SDL3/SDL.h>
+
+#include "number_types.h"
+#include "sprite.h"
+
+// images loaded during a single init, more than the game has
+const u32 ASSET_LOADER_CAPACITY    = 32;
+const u32 ASSET_LOADER_MAX_WORKERS = 16;
+
+struct Asset_Job {
+    const char*  path;
+    Img*         img;
+    // decoded by a worker, turned into a texture and freed on the render thread
+    SDL_Surface* surface;
+    // set under the mutex, images from the asset pack are already done when they are added
+    bool         done;
+    char         error[128];
+};
+
+// Decodes images on worker threads while the main thread keeps initializing,
+// only the texture uploads have to happen on the render thread.
+//
+//   asset_loader_add_*   for every image, the paths have to stay alive until the end
+//   asset_loader_start   the workers begin decoding
+//   ...                  anything that doesnt need the textures yet
+//   asset_loader_finish  uploads the textures as the workers finish them
+//   asset_loader_cancel  instead of finish when init fails in between, the workers still use the loader
+struct Asset_Loader {
+    std::array<Asset_Job, ASSET_LOADER_CAPACITY> jobs;
+    u32 job_count;
+    u32 idx_next_job; // the next one a worker takes, guarded by mutex
+
+    SDL_Mutex*     mutex;
+    SDL_Condition* job_done;
+    std::array<SDL_Thread*, ASSET_LOADER_MAX_WORKERS> workers;
+    u32 worker_count;
+};
+
+// called on the render thread after every uploaded texture
+using Asset_Progress_Fn = void (*)(u32 loaded, u32 total, void* user);
+
+void asset_loader_add_img(Asset_Loader& l, Img& i, const char* path);
+// Asserts that the metadata of the sprite is already initialized, like sprite_load.
+void asset_loader_add_sprite(Asset_Loader& l, Sprite& s, const char* path);
+
+// One worker per core, at most one per image that needs decoding. If the threads cant
+// be created the images are decoded by asset_loader_finish instead.
+void asset_loader_start(Asset_Loader& l);
+
+// Has to be called on the render thread, waits for the workers.
+//
+// returns false if any of the images failed to load
+bool asset_loader_finish(Asset_Loader& l, SDL_Renderer* r, Asset_Progress_Fn progress, void* user);
+// Waits for the images the workers are on and throws away everything decoded so far, nothing gets uploaded.
+void asset_loader_cancel(Asset_Loader& l);
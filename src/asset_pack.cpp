@@ -0,0 +1,153 @@
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "asset_pack.h"
+
+Asset_Pack asset_pack;
+
+// maps the whole file read only, the handles arent needed anymore once the view exists
+static const u8* asset_pack_map(const char* path, usize& size) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return nullptr;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return nullptr;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) return nullptr;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!view) return nullptr;
+
+    size = (usize)file_size.QuadPart;
+    return (const u8*)view;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) return nullptr;
+
+    size = (usize)st.st_size;
+    return (const u8*)view;
+#endif
+}
+
+static void asset_pack_unmap(const u8* data, usize size) {
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(data);
+#else
+    munmap((void*)data, size);
+#endif
+}
+
+// only the index is checked, the data itself is not touched so that nothing gets paged in
+static bool asset_pack_is_valid(const u8* data, usize size) {
+    if (size < sizeof(Asset_Pack_Header)) return false;
+
+    Asset_Pack_Header header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != ASSET_PACK_MAGIC || header.version != ASSET_PACK_VERSION) return false;
+    if (header.entry_count > (size - sizeof(header)) / sizeof(Asset_Pack_Entry)) return false;
+
+    const auto* entries = (const Asset_Pack_Entry*)(data + sizeof(header));
+    for (u32 idx = 0; idx < header.entry_count; idx++) {
+        const auto& entry = entries[idx];
+        if (entry.path[ASSET_PACK_PATH_CAPACITY - 1] != '\0')            return false;
+        if (entry.offset > size || entry.size > size - entry.offset)     return false;
+        if (entry.kind == Asset_Kind::Pixels && entry.size != (u64)entry.width * entry.height * 4) return false;
+        if (idx > 0 && std::strcmp(entries[idx - 1].path, entry.path) >= 0) return false;
+    }
+
+    return true;
+}
+
+bool asset_pack_open(Asset_Pack& p, const char* path, bool skip_stale) {
+    usize size = 0;
+    const u8* data = asset_pack_map(path, size);
+    if (!data) {
+        SDL_Log("Could not map asset pack %s, loading loose files instead\n", path);
+        return false;
+    }
+
+    if (!asset_pack_is_valid(data, size)) {
+        SDL_Log("Asset pack %s is malformed or from another version, loading loose files instead\n", path);
+        asset_pack_unmap(data, size);
+        return false;
+    }
+
+    Asset_Pack_Header header;
+    std::memcpy(&header, data, sizeof(header));
+
+    p.data    = data;
+    p.size    = size;
+    p.entries = {(const Asset_Pack_Entry*)(data + sizeof(header)), header.entry_count};
+    p.stale.assign(p.entries.size(), 0);
+
+    // a stat per entry, only worth it while the loose files are being edited
+    if (!skip_stale) return true;
+    SDL_PathInfo pack_info;
+    if (!SDL_GetPathInfo(path, &pack_info)) return true;
+    for (usize idx = 0; idx < p.entries.size(); idx++) {
+        SDL_PathInfo info;
+        if (!SDL_GetPathInfo(p.entries[idx].path, &info) || info.modify_time <= pack_info.modify_time) continue;
+
+        SDL_Log("%s is newer than asset pack %s, loading the loose file instead\n", p.entries[idx].path, path);
+        p.stale[idx] = 1;
+    }
+    return true;
+}
+
+void asset_pack_close(Asset_Pack& p) {
+    if (p.data) asset_pack_unmap(p.data, p.size);
+    p = {};
+}
+
+const Asset_Pack_Entry* asset_pack_find(const Asset_Pack& p, const char* path) {
+    usize lo = 0;
+    usize hi = p.entries.size();
+    while (lo < hi) {
+        const usize mid = lo + (hi - lo) / 2;
+        const int   cmp = std::strcmp(p.entries[mid].path, path);
+        if (cmp == 0) return p.stale[mid] ? nullptr : &p.entries[mid];
+        if (cmp < 0) lo = mid + 1;
+        else         hi = mid;
+    }
+    return nullptr;
+}
+
+std::span<const u8> asset_pack_bytes(const Asset_Pack& p, const Asset_Pack_Entry& entry) {
+    return {p.data + entry.offset, (usize)entry.size};
+}
+
+SDL_IOStream* asset_open_io(const char* path) {
+    const auto* entry = asset_pack_find(asset_pack, path);
+    if (entry && entry->kind == Asset_Kind::Raw) {
+        const auto bytes = asset_pack_bytes(asset_pack, *entry);
+        return SDL_IOFromConstMem(bytes.data(), bytes.size());
+    }
+    return SDL_IOFromFile(path, "rb");
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include <SDL3/SDL.h>
+
+#include "number_types.h"
+
+// Every asset in a single file, written by tools/asset_pack_builder.cpp and mapped into memory at startup.
+// Images are stored already decoded, the textures are created straight from the mapped pixels.
+//
+// layout: Asset_Pack_Header, entry_count Asset_Pack_Entry sorted by path, then the data of every entry
+// starting at a multiple of ASSET_PACK_ALIGNMENT. Everything is little endian.
+
+// relative to the working directory, like the loose assets
+const char* const ASSET_PACK_PATH = "assets.pack";
+
+const u32 ASSET_PACK_MAGIC         = 0x50464f46; // "FOFP"
+const u32 ASSET_PACK_VERSION       = 1;
+const u32 ASSET_PACK_PATH_CAPACITY = 64;
+const u64 ASSET_PACK_ALIGNMENT     = 16;
+// the format of the decoded images, 4 bytes per pixel in the order r g b a
+const SDL_PixelFormat ASSET_PACK_PIXEL_FORMAT = SDL_PIXELFORMAT_RGBA32;
+
+enum struct Asset_Kind : u32 {
+    Raw,    // the file as it is (fonts, audio, levels)
+    Pixels, // a decoded image, rows without padding
+};
+
+struct Asset_Pack_Header {
+    u32 magic;
+    u32 version;
+    u32 entry_count;
+    u32 reserved;
+};
+
+struct Asset_Pack_Entry {
+    // the same path that the game loads the loose file with, like "assets/art/props/barrel.png", zero padded
+    char       path[ASSET_PACK_PATH_CAPACITY];
+    Asset_Kind kind;
+    u32        width;  // only for pixels
+    u32        height; // only for pixels
+    u32        reserved;
+    u64        offset; // from the start of the pack
+    u64        size;
+};
+static_assert(sizeof(Asset_Pack_Header) == 16);
+static_assert(sizeof(Asset_Pack_Entry)  == 96);
+
+struct Asset_Pack {
+    const u8*                         data = nullptr;
+    usize                             size = 0;
+    std::span<const Asset_Pack_Entry> entries;
+    std::vector<u8>                   stale; // per entry, the loose file was saved after the pack was built
+};
+
+// Opened at the start of init, while it is empty every asset is loaded from its loose file instead.
+extern Asset_Pack asset_pack;
+
+// returns false if the file is missing or isnt a valid pack. With skip_stale the entries whose loose file is
+// newer than the pack are logged and skipped, so an old pack doesnt hide edits. Otherwise the pack always wins
+// over the loose files and none of them are touched.
+bool asset_pack_open(Asset_Pack& p, const char* path, bool skip_stale);
+void asset_pack_close(Asset_Pack& p);
+
+// binary search over the index, nullptr if the pack doesnt have it or the entry is stale
+const Asset_Pack_Entry* asset_pack_find(const Asset_Pack& p, const char* path);
+// points into the mapping, valid until the pack is closed
+std::span<const u8> asset_pack_bytes(const Asset_Pack& p, const Asset_Pack_Entry& entry);
+
+// A stream over the raw asset, from the pack without copying if it is in there, otherwise from the loose file.
+// returns nullptr on error
+SDL_IOStream* asset_open_io(const char* path);
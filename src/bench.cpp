@@ -0,0 +1,78 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <SDL3/SDL.h>
+
+#include "bench.h"
+#include "perf.h"
+#include "scenario.h"
+
+bool bench_parse_args(Bench& b, int argc, char** argv) {
+    for (int idx = 1; idx < argc; idx++) {
+        const char* arg = argv[idx];
+        const char* value = (idx + 1 < argc) ? argv[idx + 1] : nullptr;
+
+        if (std::strcmp(arg, "--headless") == 0) {
+            b.headless = true;
+        } else if (std::strcmp(arg, "--bench") == 0 && value) {
+            char* end = nullptr;
+            const auto frames = std::strtoul(value, &end, 10);
+            if (end == value || *end != '\0' || frames == 0) {
+                SDL_Log("Invalid value '%s' for argument %s\n", value, arg);
+                return false;
+            }
+            b.enabled = true;
+            b.frames  = (u32)frames;
+            idx++;
+        } else if (std::strcmp(arg, "--bench-out") == 0 && value) {
+            b.out_path = value;
+            idx++;
+        }
+    }
+
+    return true;
+}
+
+bool bench_write_report(const Bench& b, const Scenario& s) {
+    FILE* out = stdout;
+    if (b.out_path) {
+        out = std::fopen(b.out_path, "w");
+        if (!out) {
+            SDL_Log("Could not open bench report '%s' for writing!\n", b.out_path);
+            return false;
+        }
+    }
+
+    const auto percentiles = perf_frame_time_percentiles(perf);
+    const f64  frames      = perf.frame_count > 0 ? (f64)perf.frame_count : 1.0;
+
+    std::fprintf(out, "{\n");
+    std::fprintf(out, "    \"scenario\": \"%s\",\n",                 s.name);
+    std::fprintf(out, "    \"seed\": %llu,\n",                       (unsigned long long)s.seed);
+    std::fprintf(out, "    \"frames\": %llu,\n",                     (unsigned long long)perf.frame_count);
+    std::fprintf(out, "    \"frame_ms_p50\": %.4f,\n",               percentiles.p50_ms);
+    std::fprintf(out, "    \"frame_ms_p95\": %.4f,\n",               percentiles.p95_ms);
+    std::fprintf(out, "    \"frame_ms_p99\": %.4f,\n",               percentiles.p99_ms);
+    std::fprintf(out, "    \"allocs_per_frame\": %.4f,\n",           perf.total.allocs / frames);
+    std::fprintf(out, "    \"alloc_bytes_per_frame\": %.4f,\n",      perf.total.alloc_bytes / frames);
+    std::fprintf(out, "    \"draw_calls_per_frame\": %.4f,\n",       perf.total.draw_calls / frames);
+    std::fprintf(out, "    \"texture_switches_per_frame\": %.4f,\n", perf.total.texture_switches / frames);
+    std::fprintf(out, "    \"collision_tests_per_frame\": %.4f,\n",  perf.total.collision_tests / frames);
+    std::fprintf(out, "    \"alloc_tracking\": %d,\n",               PERF_TRACK_ALLOCATIONS ? 1 : 0);
+
+    // allocations are only counted in the innermost zone, the time includes nested zones
+    std::fprintf(out, "    \"zones\": {");
+    for (usize idx = 0; idx < perf.zone_count; idx++) {
+        const auto& zone = perf.zones_total[idx];
+        std::fprintf(out, "%s\n        \"%s\": {", idx > 0 ? "," : "", zone.name);
+        std::fprintf(out, "\"ms_per_frame\": %.4f, ",            zone.time_ns / 1'000'000.0 / frames);
+        std::fprintf(out, "\"allocs_per_frame\": %.4f, ",        zone.allocs / frames);
+        std::fprintf(out, "\"alloc_bytes_per_frame\": %.4f}",    zone.alloc_bytes / frames);
+    }
+    std::fprintf(out, "%s}\n", perf.zone_count > 0 ? "\n    " : "");
+    std::fprintf(out, "}\n");
+
+    if (out != stdout) std::fclose(out);
+    return true;
+}
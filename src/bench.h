@@ -0,0 +1,29 @@
+#pragma once
+
+#include "number_types.h"
+
+struct Scenario;
+
+struct Bench {
+    bool        enabled  = false;
+    // no visible window, renders through the offscreen video driver
+    bool        headless = false;
+    u32         frames   = 600;
+    // the report goes to stdout when there is no path
+    const char* out_path = nullptr;
+};
+
+// Recognized arguments:
+//   --bench <frames>     runs the given amount of frames with a fixed dt as fast as possible and exits
+//   --bench-out <path>   where to write the json report
+//   --headless           dont open a visible window
+//
+// Unknown arguments are skipped so that other systems can parse their own.
+//
+// returns false on malformed arguments
+bool bench_parse_args(Bench& b, int argc, char** argv);
+
+// Writes the stats collected in `perf` as a flat json object.
+//
+// returns false on error
+bool bench_write_report(const Bench& b, const Scenario& s);
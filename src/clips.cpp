@@ -0,0 +1,132 @@
+#include <array>
+#include <span>
+
+#include "clips.h"
+#include "entities/entity.h"
+
+// which sprite sheet (and overlays drawn on top of it) a clip is played on
+enum struct Clip_Sheet { Player, Enemy, Boss, Barrel };
+
+static constexpr std::span<const u32> clip_sheet_frames(Clip_Sheet sheet) {
+    switch (sheet) {
+        case Clip_Sheet::Player: return sprite_player_frames;
+        case Clip_Sheet::Enemy:  return sprite_enemy_frames;
+        case Clip_Sheet::Boss:   return sprite_enemy_boss_frames;
+        case Clip_Sheet::Barrel: return sprite_barrel_frames;
+    }
+    return {};
+}
+
+// knife and gun sheets drawn with the same row and col as the entity
+static constexpr std::span<const u32> clip_sheet_overlay_frames(Clip_Sheet sheet, u32 idx_overlay) {
+    switch (sheet) {
+        case Clip_Sheet::Player: return idx_overlay == 0 ? std::span<const u32>{sprite_knife_player_frames} : std::span<const u32>{sprite_gun_player_frames};
+        case Clip_Sheet::Enemy:  return idx_overlay == 0 ? std::span<const u32>{sprite_knife_enemy_frames}  : std::span<const u32>{sprite_gun_enemy_frames};
+        case Clip_Sheet::Boss:   return {};
+        case Clip_Sheet::Barrel: return {};
+    }
+    return {};
+}
+
+// clips.h declares it extern, so this still has external linkage
+constexpr Clip clips[(u32)Clip_Id::COUNT] = {
+#define CLIP(id, sheet, row, frame_count, frame_duration_ms, looping, fadeout_perc_per_sec) \
+    { (u32)row, frame_count, frame_duration_ms, looping, fadeout_perc_per_sec },
+#include "clips.def"
+#undef CLIP
+};
+
+static constexpr Clip_Id clip_def_ids[] = {
+#define CLIP(id, ...) Clip_Id::id,
+#include "clips.def"
+#undef CLIP
+};
+
+static constexpr Clip_Sheet clip_def_sheets[] = {
+#define CLIP(id, sheet, ...) Clip_Sheet::sheet,
+#include "clips.def"
+#undef CLIP
+};
+
+static constexpr bool clip_valid(const Clip& c, Clip_Sheet sheet) {
+    const auto frames = clip_sheet_frames(sheet);
+
+    if (c.anim_idx >= frames.size())              return false;
+    if (c.frame_count != frames[c.anim_idx])      return false;
+    if (c.frame_duration_ms == 0)                 return false;
+    if (c.fadeout_perc_per_sec < 0.0f)            return false;
+
+    // an overlay either doesnt have the row at all or has a frame for every frame of the clip
+    for (u32 idx_overlay = 0; idx_overlay < 2; idx_overlay++) {
+        const auto overlay = clip_sheet_overlay_frames(sheet, idx_overlay);
+        if (overlay.empty()) continue;
+        if (overlay[c.anim_idx] != 0 && overlay[c.anim_idx] < c.frame_count) return false;
+    }
+
+    return true;
+}
+
+static constexpr bool clips_valid() {
+    if (std::size(clip_def_ids) != (u32)Clip_Id::COUNT) return false;
+
+    for (u32 idx = 0; idx < std::size(clip_def_ids); idx++) {
+        // clips.def has to follow the order of clip_ids.def
+        if ((u32)clip_def_ids[idx] != idx) return false;
+        if (!clip_valid(clips[idx], clip_def_sheets[idx])) return false;
+    }
+
+    return true;
+}
+
+static_assert(clips_valid(), "clips.def doesnt match clip_ids.def or the sprite sheets");
+
+static constexpr Clip_Box clip_boxes[] = {
+#define BOX(clip, kind, frame_first, frame_last, x, y, w, h) \
+    { Clip_Id::clip, Clip_Box_Kind::kind, frame_first, frame_last, { x, y, w, h } },
+#include "clip_boxes.def"
+#undef BOX
+};
+
+static constexpr bool clip_boxes_valid() {
+    for (u32 idx = 0; idx < std::size(clip_boxes); idx++) {
+        const auto& box = clip_boxes[idx];
+
+        // grouped by clip, in the order of clip_ids.def
+        if (idx > 0 && (u32)box.clip < (u32)clip_boxes[idx - 1].clip) return false;
+        if (box.frame_first > box.frame_last)                          return false;
+        if (box.frame_last >= clips[(u32)box.clip].frame_count)        return false;
+        if (box.offsets.w <= 0.0f || box.offsets.h <= 0.0f)            return false;
+    }
+
+    return true;
+}
+
+static_assert(clip_boxes_valid(), "clip_boxes.def is out of order or doesnt fit the clips");
+
+struct Clip_Box_Range {
+    u32 first;
+    u32 count;
+};
+
+// where the boxes of every clip are in clip_boxes
+static constexpr auto clip_box_ranges = [] {
+    std::array<Clip_Box_Range, (u32)Clip_Id::COUNT> res = {};
+    for (u32 idx = 0; idx < std::size(clip_boxes); idx++) {
+        auto& range = res[(u32)clip_boxes[idx].clip];
+        if (range.count == 0) range.first = idx;
+        range.count++;
+    }
+    return res;
+}();
+
+const SDL_FRect* clip_find_box(Clip_Id id, Clip_Box_Kind kind, u32 frame) {
+    if (id == CLIP_NONE) return nullptr;
+
+    const auto& range = clip_box_ranges[(u32)id];
+    for (u32 idx = range.first; idx < range.first + range.count; idx++) {
+        const auto& box = clip_boxes[idx];
+        if (box.kind == kind && frame >= box.frame_first && frame <= box.frame_last) return &box.offsets;
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include "number_types.h"
+
+enum struct Clip_Id : u32 {
+#define CLIP_ID(id) id,
+#include "clip_ids.def"
+#undef CLIP_ID
+    COUNT // keep this last
+};
+
+// for animations that werent started from the clip table
+const Clip_Id CLIP_NONE = Clip_Id::COUNT;
+
+struct Clip {
+    // row in the sprite sheet
+    u32  anim_idx;
+    u32  frame_count;
+    u64  frame_duration_ms;
+    bool looping;
+    // 0 means the clip doesnt fade out
+    f32  fadeout_perc_per_sec;
+};
+
+// defined in clips.cpp from clips.def
+extern const Clip clips[(u32)Clip_Id::COUNT];
+
+inline const Clip& clip_get(Clip_Id id) {
+    return clips[(u32)id];
+}
+
+enum struct Clip_Box_Kind : u8 {
+    // deals damage
+    Hurt,
+    // receives damage
+    Hit,
+};
+
+// A box that is active for a range of frames of a clip, defined in clip_boxes.def.
+struct Clip_Box {
+    Clip_Id       clip;
+    Clip_Box_Kind kind;
+    u32           frame_first;
+    u32           frame_last;
+    // relative to the entity position, for an entity facing right
+    SDL_FRect     offsets;
+};
+
+// nullptr when the clip doesnt have a box of that kind on that frame
+const SDL_FRect* clip_find_box(Clip_Id id, Clip_Box_Kind kind, u32 frame);
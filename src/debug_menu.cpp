@@ -1,17 +1,137 @@
 #include "debug_menu.h"
 #include "draw.h"
 #include "settings.h"
+#include "perf.h"
+#include "game.h"
 
 #include <SDL3/SDL.h>
 
-#include <string>
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+
+static constexpr const char* entity_type_names[] = {"player", "enemy", "barrel", "collectible"};
+static_assert((u32)Entity_Type::Player      == 0);
+static_assert((u32)Entity_Type::Collectible == std::size(entity_type_names) - 1);
+
+static void histogram_push(Debug_Menu_Histogram& h, u64 value_ms) {
+    const u8 bucket = value_ms < DEBUG_MENU_HISTOGRAM_BUCKETS ? (u8)value_ms : DEBUG_MENU_HISTOGRAM_BUCKETS - 1;
+
+    if (h.count == DEBUG_MENU_HISTOGRAM_WINDOW) {
+        // the oldest sample falls out of the window
+        h.buckets[h.samples[h.next]]--;
+    } else {
+        h.count++;
+    }
+
+    h.samples[h.next] = bucket;
+    h.buckets[bucket]++;
+    h.next = (h.next + 1) % DEBUG_MENU_HISTOGRAM_WINDOW;
+}
+
+static void line_set_text(Debug_Menu& dm, usize idx_line, const char* text) {
+    if (dm.lines[idx_line] == text) return;
+    dm.lines[idx_line] = text;
+    dm.text_dirty = true;
+}
+
+static void debug_menu_rebuild_text(Debug_Menu& dm, const Game& g) {
+    dm.text.atlas = &g.atlas_tiny_mono;
+    text_batch_clear(dm.text);
+
+    const SDL_FColor color = color_to_fcolor(settings.color_text);
+    const f32 line_height  = text_line_height(g.atlas_tiny_mono, dm.text_scale);
+    f32 y = dm.width_border;
+    for (const auto& line : dm.lines) {
+        text_batch_add(dm.text, line, {.x = dm.width_border, .y = y, .scale = dm.text_scale, .color = color});
+        y += line_height;
+    }
+    dm.text_dirty = false;
+}
+
+void debug_menu_update(Debug_Menu& dm, const Game& g) {
+    histogram_push(dm.hist_dt, g.dt);
+    histogram_push(dm.hist_dt_real, g.dt_real);
 
-void debug_menu_update(Debug_Menu& dm) {
     if (!dm.show) return;
+
+    std::array<u32, std::size(entity_type_names)> counts = {};
+    u32 count_sleeping = 0;
+    for (const auto& e : g.entities) {
+        counts[(u32)e.type]++;
+        if (e.sleeping) count_sleeping++;
+    }
+
+    // these are from the last finished frame, the current one is still being counted
+    const auto& c = perf.last_frame;
+    char  buf[64];
+    usize idx_line = 0;
+
+    std::snprintf(buf, sizeof(buf), "frame %.1fms dt %llu real %llu", perf.frame_time_ns / 1'000'000.0, (unsigned long long)g.dt, (unsigned long long)g.dt_real);
+    line_set_text(dm, idx_line++, buf);
+    std::snprintf(buf, sizeof(buf), "entities %zu asleep %u", g.entities.size(), count_sleeping);
+    line_set_text(dm, idx_line++, buf);
+    std::snprintf(buf, sizeof(buf), "anims %u done %u", animations.count_active, animations.count_finished);
+    line_set_text(dm, idx_line++, buf);
+    std::snprintf(buf, sizeof(buf), " %s %u %s %u", entity_type_names[0], counts[0], entity_type_names[1], counts[1]);
+    line_set_text(dm, idx_line++, buf);
+    std::snprintf(buf, sizeof(buf), " %s %u %s %u", entity_type_names[2], counts[2], entity_type_names[3], counts[3]);
+    line_set_text(dm, idx_line++, buf);
+    std::snprintf(buf, sizeof(buf), " bullets %u particles %u", g.bullets.count, g.particles.count);
+    line_set_text(dm, idx_line++, buf);
+    std::snprintf(buf, sizeof(buf), "sheets %u loads %u", g.sheets.resident, g.sheets.loads);
+    line_set_text(dm, idx_line++, buf);
+    std::snprintf(buf, sizeof(buf), "draw calls %llu", (unsigned long long)c.draw_calls);
+    line_set_text(dm, idx_line++, buf);
+    std::snprintf(buf, sizeof(buf), "tex switches %llu", (unsigned long long)c.texture_switches);
+    line_set_text(dm, idx_line++, buf);
+    std::snprintf(buf, sizeof(buf), "collision tests %llu", (unsigned long long)c.collision_tests);
+    line_set_text(dm, idx_line++, buf);
+    if (PERF_TRACK_ALLOCATIONS) {
+        std::snprintf(buf, sizeof(buf), "allocs %llu (%llu B)", (unsigned long long)c.allocs, (unsigned long long)c.alloc_bytes);
+        line_set_text(dm, idx_line++, buf);
+
+        const Perf_Zone_Stats* top = nullptr;
+        for (usize idx = 0; idx < perf.zone_count; idx++) {
+            const auto& zone = perf.zones_last_frame[idx];
+            if (!top || zone.allocs > top->allocs) top = &zone;
+        }
+        if (top) {
+            std::snprintf(buf, sizeof(buf), " most in %s %llu (%llu B)", top->name, (unsigned long long)top->allocs, (unsigned long long)top->alloc_bytes);
+        } else {
+            std::snprintf(buf, sizeof(buf), " no perf zones");
+        }
+        line_set_text(dm, idx_line++, buf);
+    } else {
+        line_set_text(dm, idx_line++, "allocs not tracked");
+        line_set_text(dm, idx_line++, " (build with FOF_TRACK_ALLOCATIONS)");
+    }
+    std::snprintf(buf, sizeof(buf), "dt | dt real (0-%zums)", DEBUG_MENU_HISTOGRAM_BUCKETS - 1);
+    line_set_text(dm, idx_line++, buf);
+
+    assert(idx_line == DEBUG_MENU_LINE_COUNT);
+
+    if (dm.text_dirty) debug_menu_rebuild_text(dm, g);
 }
 
-static std::string debug_menu_get_content(/*const Debug_Menu& dm*/) {
-    return "heyyyyy";
+static void debug_menu_draw_histogram(SDL_Renderer* r, const Debug_Menu_Histogram& h, const SDL_FRect& area, const Color& color) {
+    std::array<SDL_FRect, DEBUG_MENU_HISTOGRAM_BUCKETS> bars;
+
+    u32 max = 1;
+    for (auto bucket : h.buckets) max = std::max(max, bucket);
+
+    const f32 bar_w = area.w / DEBUG_MENU_HISTOGRAM_BUCKETS;
+    for (usize idx = 0; idx < DEBUG_MENU_HISTOGRAM_BUCKETS; idx++) {
+        const f32 bar_h = area.h * h.buckets[idx] / (f32)max;
+        bars[idx] = {area.x + idx * bar_w, area.y + area.h - bar_h, bar_w * 0.8f, bar_h};
+    }
+
+    // all of the bars in a single call
+    SDL_SetRenderDrawColor(r, color[0], color[1], color[2], color[3]);
+    bool ok = SDL_RenderFillRects(r, bars.data(), bars.size());
+    if (!ok) SDL_Log("Failed to draw histogram! SDL err: %s\n", SDL_GetError());
+    perf_count_draw_call();
+    SDL_SetRenderDrawColor(r, 0, 0, 0, SDL_ALPHA_OPAQUE);
 }
 
 void debug_menu_draw(const Debug_Menu& dm, SDL_Renderer* r) {
@@ -23,13 +143,15 @@ void debug_menu_draw(const Debug_Menu& dm, SDL_Renderer* r) {
     };
     draw_box(r, dst_box, opts_box);
 
-    const auto content = debug_menu_get_content();
-    const auto font_width_from_border = dm.width_border + dm.width_font;
-    const auto width_max = dm.width_box - 2*dm.width_border; // will probably need some additional space for breathing
-    const auto height_max = dm.height_box - 2*dm.width_border; // same thing here
-    const SDL_FRect dst_text = {font_width_from_border, font_width_from_border, width_max, height_max};
-    const Draw_Text_Opts opts_text = {
-        .color = settings.color_text
-    };
-    draw_text(r, dst_text, opts_text);
+    // every line in a single call
+    text_batch_draw(dm.text, r);
+
+    f32 y = dm.width_border;
+    if (dm.text.atlas) y += DEBUG_MENU_LINE_COUNT * text_line_height(*dm.text.atlas, dm.text_scale);
+
+    const f32 width_histogram = (dm.width_box - 3*dm.width_border) / 2;
+    const SDL_FRect area_dt      = {dm.width_border,                     y, width_histogram, dm.height_histogram};
+    const SDL_FRect area_dt_real = {2*dm.width_border + width_histogram, y, width_histogram, dm.height_histogram};
+    debug_menu_draw_histogram(r, dm.hist_dt,      area_dt,      settings.colors_hurtbox_border);
+    debug_menu_draw_histogram(r, dm.hist_dt_real, area_dt_real, settings.colors_hitbox_border);
 }
@@ -1,17 +1,46 @@
 #pragma once
 
+#include <array>
+#include <string>
+
 #include "settings.h"
+#include "number_types.h"
+#include "text.h"
 
-struct Debug_Menu {
-    f32 width_font   = 12;
-    f32 width_border = 2;
-    f32 height_box   = SCREEN_HEIGHT * 3.0f/10.0f;
-    f32 width_box    = SCREEN_WIDTH  * 3.0f/10.0f;
-    bool show        = false;
-    Settings& s      = settings;
+struct SDL_Renderer;
+struct Game;
+
+const usize DEBUG_MENU_LINE_COUNT        = 13;
+const usize DEBUG_MENU_HISTOGRAM_BUCKETS = 16;  // 1ms each, the last one collects everything above
+const usize DEBUG_MENU_HISTOGRAM_WINDOW  = 120; // amount of frames the histogram is built from
+
+// Distribution of a frame time over the last DEBUG_MENU_HISTOGRAM_WINDOW frames.
+struct Debug_Menu_Histogram {
+    std::array<u32, DEBUG_MENU_HISTOGRAM_BUCKETS> buckets = {};
+    std::array<u8,  DEBUG_MENU_HISTOGRAM_WINDOW>  samples = {}; // bucket of every sample in the window
+    usize                                         next    = 0;
+    usize                                         count   = 0;
 };
 
-struct SDL_Renderer;
+struct Debug_Menu {
+    f32 width_font       = 12;
+    f32 width_border     = 2;
+    f32 height_box       = SCREEN_HEIGHT;
+    f32 width_box        = SCREEN_WIDTH  * 6.0f/10.0f;
+    f32 height_histogram = 8;
+    // text is rasterized at the font size and scaled down to the logical resolution
+    f32 text_scale       = 0.2f;
+    bool show            = false;
+    const Settings& s    = settings;
+
+    std::array<std::string, DEBUG_MENU_LINE_COUNT> lines;
+    // quads of all of the lines, only rebuilt when one of them changes
+    Text_Batch text;
+    bool       text_dirty = true;
+    Debug_Menu_Histogram hist_dt;
+    Debug_Menu_Histogram hist_dt_real;
+};
 
 void debug_menu_draw(const Debug_Menu& m, SDL_Renderer* r);
-void debug_menu_update(Debug_Menu& m);
+// Has to be called once per frame (even when hidden, so that the histograms keep up).
+void debug_menu_update(Debug_Menu& m, const Game& g);
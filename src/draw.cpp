@@ -2,17 +2,20 @@
 
 #include "draw.h"
 #include "settings.h"
+#include "perf.h"
 
 void _draw_box(SDL_Renderer* r, const SDL_FRect& box, const std::array<f32, 4> colors_border, const std::array<f32, 4> colors_fill) {
     SDL_SetRenderDrawBlendMode(r, SDL_BLENDMODE_BLEND);
     SDL_SetRenderDrawColor(r, colors_border[0], colors_border[1], colors_border[2], colors_border[3]);
     bool ok = SDL_RenderRect(r, &box);
     if (!ok) SDL_Log("Failed to draw box! SDL err: %s\n", SDL_GetError());
+    perf_count_draw_call();
 
     SDL_SetRenderDrawBlendMode(r, SDL_BLENDMODE_BLEND);
     SDL_SetRenderDrawColor(r, colors_fill[0], colors_fill[1], colors_fill[2], colors_fill[3]);
     ok = SDL_RenderFillRect(r, &box);
     if (!ok) SDL_Log("Failed to draw box! SDL err: %s\n", SDL_GetError());
+    perf_count_draw_call();
 
     SDL_SetRenderDrawColor(r, 0, 0, 0, SDL_ALPHA_OPAQUE);
 }
@@ -50,6 +53,14 @@ void draw_hitbox(SDL_Renderer* r, const Vec2<f32>& world_coords, const SDL_FRect
 void draw_level(SDL_Renderer* r, const Game& g) {
     const SDL_FRect dst = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
     SDL_RenderTexture(r, g.bg.img, &g.camera, &dst);
+    perf_count_draw_call(g.bg.img);
+    for (const auto& prop : g.curr_level_info.props) {
+        const auto& img = g.prop_imgs[prop.idx_img];
+        const SDL_FRect prop_dst = {prop.x - g.camera.x, prop.y - g.camera.y, img.width, img.height};
+        if (prop_dst.x + prop_dst.w < 0.0f || prop_dst.x > SCREEN_WIDTH) continue;
+        SDL_RenderTexture(r, img.img, nullptr, &prop_dst);
+        perf_count_draw_call(img.img);
+    }
     if (settings.show_collision_boxes) {
         for (const auto& box : level_info_get_collision_boxes(g.curr_level_info)) {
             // Draw collision boxes relative to camera
@@ -61,6 +72,10 @@ void draw_level(SDL_Renderer* r, const Game& g) {
             };
             _draw_box(r, screen_box, settings.colors_collision_box_border, settings.colors_collision_box_fill);
         }
+        for (const auto& box : level_info_get_static_boxes(g.curr_level_info)) {
+            const SDL_FRect screen_box = {box.x - g.camera.x, box.y - g.camera.y, box.w, box.h};
+            _draw_box(r, screen_box, settings.colors_collision_box_border, settings.colors_collision_box_fill);
+        }
     }
 }
 
@@ -80,6 +95,7 @@ void draw_shadow(SDL_Renderer* r, Draw_Shadow_Opts opts) {
     }
     ok = SDL_RenderTexture(r, opts.g.entity_shadow.img, NULL, &shadow_box_screen);
     if (!ok) SDL_Log("Failed to draw shadow! SDL err: %s\n", SDL_GetError());
+    perf_count_draw_call(opts.g.entity_shadow.img);
     ok = SDL_SetTextureAlphaModFloat(opts.g.entity_shadow.img, 1.0f);
     if (!ok) SDL_Log("Failed to change opacity for shadow! SDL err: %s\n", SDL_GetError());
 }
@@ -88,8 +104,22 @@ void draw_box(SDL_Renderer* r, const SDL_FRect dst, Draw_Box_Opts opts) {
     _draw_box(r, dst, opts.colors_border, opts.colors_fill);
 }
 
-void draw_text(SDL_Renderer* r, const SDL_FRect dst, Draw_Text_Opts opts) {
-    _draw_box(r, dst, opts.color, opts.color);
+SDL_FColor color_to_fcolor(const Color& c) {
+    return {c[0] / 255.0f, c[1] / 255.0f, c[2] / 255.0f, c[3] / 255.0f};
+}
+
+void draw_text(SDL_Renderer* r, const Font_Atlas& atlas, std::string_view text, Vec2<f32> dst, Draw_Text_Opts opts) {
+    // reused between calls so that its capacity sticks around
+    static Text_Batch batch;
+    batch.atlas = &atlas;
+    text_batch_clear(batch);
+    text_batch_add(batch, text, {
+        .x     = dst.x,
+        .y     = dst.y,
+        .scale = opts.scale,
+        .color = color_to_fcolor(opts.color),
+    });
+    text_batch_draw(batch, r);
 }
 
 void draw_point(SDL_Renderer* r, Draw_Point_Opts opts) {
@@ -115,4 +145,5 @@ void draw_gradient_rect_geometry(SDL_Renderer* renderer, float x1, float y1, flo
     int indices[6] = {0, 1, 2, 1, 2, 3};
     
     SDL_RenderGeometry(renderer, NULL, vertices, 4, indices, 6);
+    perf_count_draw_call();
 }
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <array>
+#include <string_view>
 
 #include <SDL3/SDL.h>
 
 #include "game.h"
+#include "text.h"
 #include "vec2.h"
 
 void draw_level(SDL_Renderer* r, const Game& g);
@@ -31,11 +33,18 @@ struct Draw_Box_Opts {
 void _draw_box(SDL_Renderer* r, const SDL_FRect& box, const std::array<f32, 4> colors_border, const std::array<f32, 4> colors_fill);
 void draw_box(SDL_Renderer* r, const SDL_FRect dst, Draw_Box_Opts opts);
 
+SDL_FColor color_to_fcolor(const Color& c);
+
 struct Draw_Text_Opts {
     Color color;
+    f32   scale = 1.0f;
 };
 
-void draw_text(SDL_Renderer* r, const SDL_FRect dst, Draw_Text_Opts opts);
+// For one off strings, text that gets drawn every frame should keep its own Text_Batch
+// and only rebuild it when the text changes.
+//
+// `dst` is the top left corner in screen coordinates
+void draw_text(SDL_Renderer* r, const Font_Atlas& atlas, std::string_view text, Vec2<f32> dst, Draw_Text_Opts opts);
 
 struct Draw_Point_Opts {
     Vec2<f32>   dst_world_coords; 
@@ -27,9 +27,8 @@ Entity barrel_init(Game& g, Barrel_Init_Opts opts) {
 
     barrel.extra_barrel.held_collectible = opts.held_collectible;
     barrel.anim.sprite                   = opts.sprite;
-    animation_start(barrel.anim, { .anim_idx = (u32)Barrel_Anim::Idle });
+    animation_play(barrel.anim, Clip_Id::Barrel_Idle);
 
-    g.entities.push_back(barrel);
     return barrel;
 }
 
@@ -49,8 +48,6 @@ static bool handle_knockback(Entity& e, u64 dt) {
 Update_Result barrel_update(Entity& e, Game& g) {
     assert(e.type == Entity_Type::Barrel);
 
-    animation_update(e.anim, g.dt, g.dt_real);
-
     switch (e.extra_barrel.state) {
         case (Barrel_State::Idle): {
             while (!e.damage_queue.empty()) {
@@ -59,6 +56,7 @@ Update_Result barrel_update(Entity& e, Game& g) {
                 e.damage_queue.pop_back();
                 if (e.health <= 0) {
                     e.extra_barrel.state = Barrel_State::Destroyed;
+                    entity_emit_hit_sparks(e, g, Direction::Up, settings.spark_count_barrel);
 
                     if (e.extra_barrel.held_collectible.has_value()) {
                         collectible_drop(e.extra_barrel.held_collectible.value(), g, e);
@@ -73,10 +71,7 @@ Update_Result barrel_update(Entity& e, Game& g) {
                     }
 
                     e.z_vel = settings.barrel_jump_velocity;
-                    animation_start(e.anim, {
-                        .anim_idx = (u32)Barrel_Anim::Destroyed,
-                        .fadeout = { .enabled = true, .perc_per_sec = 1.9f }
-                    });
+                    animation_play(e.anim, Clip_Id::Barrel_Destroyed);
                 }
             }
             return Update_Result::None;
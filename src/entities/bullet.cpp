@@ -1,106 +1,165 @@
 #include "bullet.h"
 #include "../game.h"
 #include "../draw.h"
+#include "../perf.h"
 #include "../utils.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <vector>
 
-static Entity* bullet_find_target_in_path(Entity_Type shot_by, Vec2<f32> pos_start, f32 z, Direction dir, Game& g) {
-    SDL_FRect hurtbox = {pos_start.x, pos_start.y + z, SCREEN_WIDTH, 1.0f};
+struct Bullet_Hit {
+    Entity* target;
+    f32     distance; // from the start of the ray to the near edge of the hitbox
+};
+
+// the entity whose hitbox the ray reaches first, not just the first one in g.entities
+static Bullet_Hit bullet_find_nearest_target(Entity_Type shot_by, Vec2<f32> pos_start, f32 z, Direction dir, f32 length, Game& g) {
+    SDL_FRect ray = {pos_start.x, pos_start.y + z, length, 1.0f};
     if (dir == Direction::Right) {
     } else if (dir == Direction::Left) {
-        hurtbox.x = pos_start.x - SCREEN_WIDTH;
+        ray.x = pos_start.x - length;
     } else {
         unreachable("not possible");
     }
 
-    for (auto& entity : g.entities) {
-        if (entity.type == shot_by)                  continue;
-        if (entity.type == Entity_Type::Collectible) continue;
-        if (entity.type == Entity_Type::Barrel)      continue;
+    // only the cells along the row band of the ray, the grid has candidates and the hitboxes decide
+    const SDL_FRect area = {
+        ray.x - SPATIAL_GRID_BOX_MARGIN,
+        ray.y - SPATIAL_GRID_BOX_MARGIN,
+        ray.w + 2*SPATIAL_GRID_BOX_MARGIN,
+        ray.h + 2*SPATIAL_GRID_BOX_MARGIN,
+    };
+    Entity* nearest = nullptr;
+    u32     nearest_idx      = UINT32_MAX;
+    f32     nearest_distance = 0.0f;
+    spatial_grid_query(g.grid, area, [&](u32 idx) {
+        auto& entity = g.entities[idx];
+        if (entity.sleeping)                         return;
+        if (entity.type == shot_by)                  return;
+        if (entity.type == Entity_Type::Collectible) return;
+        if (entity.type == Entity_Type::Barrel)      return;
 
         auto hitbox = entity_get_world_hitbox(entity);
-        if (SDL_HasRectIntersectionFloat(&hurtbox, &hitbox)) {
-            return &entity;
+        if (!entity_boxes_intersect(ray, hitbox)) return;
+
+        // the edge facing the shooter, a shooter standing inside the hitbox hits it right away
+        const f32 edge     = dir == Direction::Right ? hitbox.x - pos_start.x : pos_start.x - (hitbox.x + hitbox.w);
+        const f32 distance = std::max(0.0f, edge);
+        // on a tie the first one in g.entities, the order of the cells doesnt decide
+        const bool closer = !nearest || distance < nearest_distance || (distance == nearest_distance && idx < nearest_idx);
+        if (closer) {
+            nearest          = &entity;
+            nearest_idx      = idx;
+            nearest_distance = distance;
         }
-    }
+    });
 
-    return nullptr;
+    return {nearest, nearest_distance};
 }
 
-Entity bullet_init(Game& g, Bullet_Init_Opts opts) {
-    Entity bullet = {};
-
+void bullet_fire(Bullet_Pool& pool, Bullet_Init_Opts opts, Game& g) {
     auto pos_start = opts.pos_creator;
     pos_start.x   += opts.offsets.x;
+    const f32 z    = opts.offsets.y;
 
-    bullet.type                   = Entity_Type::Bullet;
-    bullet.handle                 = game_generate_entity_handle(g);
-    bullet.extra_bullet.pos_start = pos_start;
-    bullet.extra_bullet.pos_curr  = pos_start;
-    bullet.x                      = pos_start.x;
-    bullet.y                      = pos_start.y;
-    bullet.z                      = opts.offsets.y;
-    bullet.dir                    = opts.dir;
-
-    Entity* target = bullet_find_target_in_path(opts.shot_by, pos_start, bullet.z, opts.dir, g);
-    if (target) {
-        bullet.extra_bullet.length = std::abs(target->x - bullet.x);
-        target->damage_queue.push_back({settings.gun_damage, bullet.dir, Hit_Type::Knockdown});
-    } else {
-        bullet.extra_bullet.length = opts.length;
+    f32 length = opts.length;
+    const auto hit = bullet_find_nearest_target(opts.shot_by, pos_start, z, opts.dir, opts.length, g);
+    if (hit.target) {
+        length = hit.distance;
+        if (!opts.harmless) hit.target->damage_queue.push_back({settings.gun_damage, opts.dir, Hit_Type::Knockdown});
     }
 
+    if (pool.count == BULLET_POOL_CAPACITY) return;
+    const u32 idx = pool.count++;
+
+    f32 x_end;
     if (opts.dir == Direction::Left) {
-        bullet.extra_bullet.pos_end = pos_start + Vec2{-bullet.extra_bullet.length, opts.thickness};
+        x_end = pos_start.x - length;
     } else if (opts.dir == Direction::Right) {
-        bullet.extra_bullet.pos_end = pos_start + Vec2{bullet.extra_bullet.length, opts.thickness};
+        x_end = pos_start.x + length;
     } else {
         unreachable("shouldnt ever happen");
     }
 
-    bullet.extra_bullet.creation_timestamp = g.time_ms;
-    auto ms_per_px                         = 2;
-    bullet.extra_bullet.time_of_flight_ms  = ms_per_px * bullet.extra_bullet.length;
-
-    g.entities.push_back(bullet);
-    return bullet;
+    const u64 ms_per_px = 2;
+    const u64 time_of_flight_ms = ms_per_px * length;
+
+    pool.x_start[idx]           = pos_start.x;
+    pool.x_curr[idx]            = pos_start.x;
+    pool.x_end[idx]             = x_end;
+    pool.y[idx]                 = pos_start.y + z;
+    pool.thickness[idx]         = opts.thickness;
+    pool.dir[idx]               = opts.dir;
+    pool.time_end_ms[idx]       = g.time_ms + time_of_flight_ms;
+    pool.time_of_flight_ms[idx] = time_of_flight_ms;
 }
 
-static void bullet_lerp_curr_pos(Entity& e, u64 time_ms) {
-    auto rate = 1.0f - (f64)(e.extra_bullet.creation_timestamp + e.extra_bullet.time_of_flight_ms - time_ms) / (f64) e.extra_bullet.time_of_flight_ms;
-    e.extra_bullet.pos_curr.x = e.extra_bullet.pos_start.x + (e.extra_bullet.pos_end.x - e.extra_bullet.pos_start.x) * rate;
+static void bullet_pool_remove(Bullet_Pool& pool, u32 idx) {
+    // the last one takes its place, the order of the tracers doesnt matter
+    const u32 last = --pool.count;
+    pool.x_start[idx]           = pool.x_start[last];
+    pool.x_curr[idx]            = pool.x_curr[last];
+    pool.x_end[idx]             = pool.x_end[last];
+    pool.y[idx]                 = pool.y[last];
+    pool.thickness[idx]         = pool.thickness[last];
+    pool.dir[idx]               = pool.dir[last];
+    pool.time_end_ms[idx]       = pool.time_end_ms[last];
+    pool.time_of_flight_ms[idx] = pool.time_of_flight_ms[last];
 }
 
-Update_Result bullet_update(Entity& e, Game& g) {
-    assert(e.type == Entity_Type::Bullet);
+void bullet_pool_update(Bullet_Pool& pool, u64 time_ms) {
+    u32 idx = 0;
+    while (idx < pool.count) {
+        if (time_ms > pool.time_end_ms[idx]) {
+            bullet_pool_remove(pool, idx);
+            continue;
+        }
 
-    if (g.time_ms > e.extra_bullet.creation_timestamp + e.extra_bullet.time_of_flight_ms) {
-        return Update_Result::Remove_Me;
+        const f64 time_left = pool.time_end_ms[idx] - time_ms;
+        const f64 rate      = pool.time_of_flight_ms[idx] > 0 ? 1.0 - time_left / pool.time_of_flight_ms[idx] : 1.0;
+        pool.x_curr[idx]    = pool.x_start[idx] + (pool.x_end[idx] - pool.x_start[idx]) * rate;
+        idx++;
     }
-
-    bullet_lerp_curr_pos(e, g.time_ms);
-
-    return Update_Result::None;
 }
 
-void bullet_draw(SDL_Renderer* r, const Entity& e, const Game& g) {
-    assert(e.type == Entity_Type::Bullet);
-
-    Vec2<f32> screen_curr = game_get_screen_coords(g, e.extra_bullet.pos_curr);
-    Vec2<f32> screen_end  = game_get_screen_coords(g, e.extra_bullet.pos_end);
-
-    static const SDL_Color white  = {230, 230, 230, 255};
-    static const SDL_Color yellow = {230, 230, 0,   255};
-
-    f32 x1 = screen_curr.x < screen_end.x ? screen_curr.x : screen_end.x;
-    f32 x2 = screen_curr.x < screen_end.x ? screen_end.x  : screen_curr.x;
-    f32 y1 = screen_curr.y + e.z;
-    f32 y2 = screen_end.y  + e.z;
-
-    if (e.dir == Direction::Left) {
-        draw_gradient_rect_geometry(r, x1, y1, x2, y2, yellow, white,  yellow, white);
-    } else {
-        draw_gradient_rect_geometry(r, x1, y1, x2, y2, white,  yellow, white,  yellow);
+void bullet_pool_draw(SDL_Renderer* r, const Bullet_Pool& pool, const Game& g) {
+    if (pool.count == 0) return;
+
+    // kept around so that drawing doesnt allocate once they are big enough
+    static std::vector<SDL_Vertex> vertices;
+    static std::vector<int>        indices;
+    vertices.clear();
+    indices.clear();
+
+    static const SDL_FColor white  = {230/255.0f, 230/255.0f, 230/255.0f, 1.0f};
+    static const SDL_FColor yellow = {230/255.0f, 230/255.0f, 0.0f,       1.0f};
+
+    for (u32 idx = 0; idx < pool.count; idx++) {
+        const f32 x_curr = pool.x_curr[idx] - g.camera.x;
+        const f32 x_end  = pool.x_end[idx]  - g.camera.x;
+        const f32 x1 = x_curr < x_end ? x_curr : x_end;
+        const f32 x2 = x_curr < x_end ? x_end  : x_curr;
+        const f32 y1 = pool.y[idx] - g.camera.y;
+        const f32 y2 = y1 + pool.thickness[idx];
+
+        // the yellow end is the front of the tracer
+        const bool left = pool.dir[idx] == Direction::Left;
+        const SDL_FColor c1 = left ? yellow : white;
+        const SDL_FColor c2 = left ? white  : yellow;
+
+        const int first = (int)vertices.size();
+        vertices.push_back({{x1, y1}, c1, {0, 0}});
+        vertices.push_back({{x2, y1}, c2, {1, 0}});
+        vertices.push_back({{x1, y2}, c1, {0, 1}});
+        vertices.push_back({{x2, y2}, c2, {1, 1}});
+
+        const int quad[6] = {0, 1, 2, 1, 2, 3};
+        for (int idx_quad : quad) indices.push_back(first + idx_quad);
     }
+
+    bool ok = SDL_RenderGeometry(r, nullptr, vertices.data(), vertices.size(), indices.data(), indices.size());
+    if (!ok) SDL_Log("Failed to draw bullets! SDL err: %s\n", SDL_GetError());
+    perf_count_draw_call();
 }
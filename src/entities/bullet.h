@@ -1,17 +1,33 @@
 #pragma once
 
+#include <array>
+#include <SDL3/SDL.h>
+
 #include "entity.h"
-#include "../game.h"
+#include "../spawn.h"
+
+struct Game;
+
+// tracers alive at the same time, past that shots still hit but arent drawn
+const u32 BULLET_POOL_CAPACITY = 1024;
 
-struct Bullet_Init_Opts {
-    Vec2<f32>   pos_creator;
-    Vec2<f32>   offsets;
-    Direction   dir;
-    Entity_Type shot_by;
-    f32         length    = SCREEN_WIDTH;
-    f32         thickness = 0.6f;
+// Bullets are hitscan, the target is hit the moment the bullet is fired,
+// what lives on is only the tracer flying towards it.
+// Every field is its own array, alive tracers are packed at the start.
+struct Bullet_Pool {
+    u32 count = 0;
+    std::array<f32,       BULLET_POOL_CAPACITY> x_start;
+    std::array<f32,       BULLET_POOL_CAPACITY> x_curr;
+    std::array<f32,       BULLET_POOL_CAPACITY> x_end;
+    std::array<f32,       BULLET_POOL_CAPACITY> y;         // top of the tracer, with the height of the gun already added
+    std::array<f32,       BULLET_POOL_CAPACITY> thickness;
+    std::array<Direction, BULLET_POOL_CAPACITY> dir;
+    std::array<u64,       BULLET_POOL_CAPACITY> time_end_ms;
+    std::array<u64,       BULLET_POOL_CAPACITY> time_of_flight_ms;
 };
 
-Entity bullet_init(Game& g, Bullet_Init_Opts opts);
-Update_Result bullet_update(Entity& e, Game& g);
-void bullet_draw(SDL_Renderer* r, const Entity& e, const Game& g);
+// Hits the nearest entity in the path of the bullet and starts its tracer.
+void bullet_fire(Bullet_Pool& pool, Bullet_Init_Opts opts, Game& g);
+void bullet_pool_update(Bullet_Pool& pool, u64 time_ms);
+// all of the tracers in a single draw call
+void bullet_pool_draw(SDL_Renderer* r, const Bullet_Pool& pool, const Game& g);
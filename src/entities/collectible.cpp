@@ -134,31 +134,32 @@ Entity collectible_init(Game& g, Collectible_Init_Opts opts) {
         case Collectible_State::Dropped: {
             anim_opts.anim_idx = (u32)Collectible_Anim::Normal;
 
-            std::vector<Rotation_Range> range;
+            Rotation_Range range;
             f32 deg_per_sec;
 
             switch (opts.type) {
                 case Collectible_Type::Knife: {
-                    if      (opts.dir == Direction::Left)  range = {{269, 271}};
-                    else if (opts.dir == Direction::Right) range = {{89, 91}};
+                    if      (opts.dir == Direction::Left)  range = {269, 271};
+                    else if (opts.dir == Direction::Right) range = {89, 91};
                     else    unreachable("not possible");
                     deg_per_sec = 2300.0f;
                 } break;
 
                 case Collectible_Type::Gun: {
-                    range = {{0, 10}};
+                    range = {0, 10};
                     deg_per_sec = 1200.0f;
                 } break;
 
                 case Collectible_Type::Food: {
-                    range = {{0, 10}};
+                    range = {0, 10};
                     deg_per_sec = 800.0f;
                 }
             }
 
             anim_opts.rotation = {
                 .enabled = true,
-                .finish_ranges = range,
+                .finish_ranges = {range},
+                .finish_range_count = 1,
                 .deg_per_sec = deg_per_sec,
                 .rotations_min = 0,
             };
@@ -174,17 +175,19 @@ Entity collectible_init(Game& g, Collectible_Init_Opts opts) {
 }
 
 static bool handle_dealing_damage(const Entity& e, Game& g) {
-    auto hurtbox = entity_get_world_hurtbox(e);
+    // props dont play clips, so their hurtbox is always there
+    const auto hurtbox = entity_get_world_hurtbox(e).value();
     bool hit_something = false;
 
     for (auto& other_e : g.entities) {
+        if (other_e.sleeping) continue;
         if (other_e.type == Entity_Type::Collectible
             || other_e.type == Entity_Type::Barrel
             || other_e.type == e.extra_collectible.created_by
         ) continue;
 
         auto hitbox = entity_get_world_hitbox(other_e);
-        if (SDL_HasRectIntersectionFloat(&hurtbox, &hitbox)) {
+        if (entity_boxes_intersect(hurtbox, hitbox)) {
             hit_something = true;
             other_e.damage_queue.push_back({settings.knife_damage, e.dir, Hit_Type::Normal});
             break;
@@ -235,7 +238,7 @@ Update_Result collectible_update(Entity& e, Game& g) {
             auto on_the_ground = handle_movement_while_dropped(e, g);
             if (on_the_ground && animation_is_finished(e.anim)) {
                 e.extra_collectible.pickupable = e.extra_collectible.created_by != Entity_Type::Player;
-                auto rotation = e.anim.rotation; // preserve the rotation so that we draw the sprite in the correct orientation
+                auto rotation = animation_rotation(e.anim); // preserve the rotation so that we draw the sprite in the correct orientation
                 rotation.enabled = false;
                 if (e.extra_collectible.instantly_disappear) {
                     e.extra_collectible.state = Collectible_State::Disappearing;
@@ -271,7 +274,6 @@ Update_Result collectible_update(Entity& e, Game& g) {
         } break;
     }
 
-    animation_update(e.anim, g.dt, g.dt_real);
     return Update_Result::None;
 }
 
@@ -286,11 +288,12 @@ void collectible_throw(Collectible_Type type, Game& g, const Entity& e) {
     // offset for it to appear like its thrown from a hand
     pos.x += 1.0f;
     pos.y -= 5.0f;
-    g.props_thrown_queue.push_back({
-        .type = type,
+    spawn_collectible(g, {
+        .type     = type,
+        .state    = Collectible_State::Thrown,
         .position = pos,
-        .dir = e.dir,
-        .thrown_by = e.type,
+        .dir      = e.dir,
+        .done_by  = e.type,
     });
 }
 
@@ -298,11 +301,12 @@ void collectible_drop(Collectible_Type type, Game& g, const Entity& e, Collectib
     auto pos = entity_get_pos(e);
     // offset for it to appear like its dropped from a hand
     pos.y -= 7.0f;
-    g.props_dropped_queue.push_back({
-        .type = type,
-        .position = pos,
-        .dir = e.dir,
-        .dropped_by = e.type,
+    spawn_collectible(g, {
+        .type                = type,
+        .state               = Collectible_State::Dropped,
+        .position            = pos,
+        .dir                 = e.dir, // could be whatever [...] this in fact, could not be whatever
+        .done_by             = e.type,
         .instantly_disappear = opts.instantly_disappear,
     });
 }
@@ -4,15 +4,6 @@
 #include "../game.h"
 #include "../number_types.h"
 
-struct Collectible_Init_Opts {
-    Collectible_Type  type;
-    Collectible_State state;
-    Vec2<f32>         position;
-    Direction         dir;
-    Entity_Type       done_by;
-    bool              instantly_disappear = false;
-};
-
 struct Collectible_Drop_Opts {
     bool instantly_disappear = false;
 };
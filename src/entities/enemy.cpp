@@ -6,6 +6,7 @@
 #include "../draw.h"
 #include "../utils.h"
 #include "entity.h"
+#include "../steering.h"
 
 Entity enemy_init(Game& g, Enemy_Init_Opts opts) {
     const auto sprite_frame_h = 48;
@@ -21,13 +22,13 @@ Entity enemy_init(Game& g, Enemy_Init_Opts opts) {
     enemy.sprite_frame_w        = sprite_frame_w;
     enemy.sprite_frame_h        = sprite_frame_h;
     enemy.collision_box_offsets = {-sprite_frame_w/7,    -3,  2*sprite_frame_w/7,    4};
-    enemy.hurtbox_offsets       = {-sprite_frame_w/7     -    10,                    -14, 10, 6};
     enemy.hitbox_offsets        = {-sprite_frame_w/6.5f, -20, 2*sprite_frame_w/6.5f, 10};
     enemy.shadow_offsets        = {-7,                   -1,  14,                    2};
     enemy.bullet_start_offsets  = {-22.0f,               -15.0f};
     enemy.dir                   = Direction::Left;
     enemy.dir_prev              = Direction::Left;
     enemy.extra_enemy.state     = Enemy_State::Standing;
+    enemy.extra_enemy.slot      = SLOT_NONE;
 
     switch (opts.type) {
         case Enemy_Type::Goon: {
@@ -36,21 +37,21 @@ Entity enemy_init(Game& g, Enemy_Init_Opts opts) {
             enemy.extra_enemy.has_knife = true;
             enemy.extra_enemy.can_spawn_knives = true;
             enemy.anim.sprite = &g.sprite_enemy_goon;
-            animation_start(enemy.anim, { .anim_idx = (u32)Enemy_Anim::Standing, .looping = true });
+            animation_play(enemy.anim, Clip_Id::Enemy_Standing);
         } break;
 
         case Enemy_Type::Thug: {
             enemy.speed = settings.enemy_thug_speed;
 
             enemy.anim.sprite = &g.sprite_enemy_thug;
-            animation_start(enemy.anim, { .anim_idx = (u32)Enemy_Anim::Standing, .looping = true });
+            animation_play(enemy.anim, Clip_Id::Enemy_Standing);
         } break;
 
         case Enemy_Type::Punk: {
             enemy.speed = settings.enemy_punk_speed;
 
             enemy.anim.sprite = &g.sprite_enemy_punk;
-            animation_start(enemy.anim, { .anim_idx = (u32)Enemy_Anim::Standing, .looping = true });
+            animation_play(enemy.anim, Clip_Id::Enemy_Standing);
         } break;
 
         case Enemy_Type::Boss: {
@@ -61,15 +62,23 @@ Entity enemy_init(Game& g, Enemy_Init_Opts opts) {
             enemy.speed = settings.enemy_boss_speed;
 
             enemy.anim.sprite = &g.sprite_enemy_boss;
-            animation_start(enemy.anim, { .anim_idx = (u32)Enemy_Boss_Anim::Standing, .looping = true });
+            animation_play(enemy.anim, Clip_Id::Boss_Standing);
         } break;
     }
 
+    // held until the enemy despawns, loaded right now if no wave prefetched it
+    const Sheet sheet = sheet_of_enemy(opts.type, opts.alt_colors);
+    sheet_acquire(g, sheet);
+    if (!sheet_require(g, sheet)) SDL_Log("Enemy spawned without its sheet!\n");
+    enemy.extra_enemy.alt_colors = opts.alt_colors && opts.type != Enemy_Type::Boss;
+    if (enemy.extra_enemy.alt_colors) enemy.anim.sprite = &sheet_sprite(g, sheet);
+
     enemy.extra_enemy.has_knife        = opts.has_knife;
     enemy.extra_enemy.can_spawn_knives = opts.can_spawn_knives;
     enemy.extra_enemy.has_gun          = opts.has_gun;
+    if (opts.has_knife) entity_weapon_gained(enemy, g, Collectible_Type::Knife);
+    if (opts.has_gun)   entity_weapon_gained(enemy, g, Collectible_Type::Gun);
 
-    g.entities.push_back(enemy);
     return enemy;
 }
 
@@ -80,81 +89,9 @@ void enemy_draw(SDL_Renderer* r, const Entity& e, Game& g) {
     if (e.extra_enemy.has_gun)   entity_draw_gun(r, e, &g);
 }
 
-static Anim_Start_Opts enemy_get_anim_knocked_down(const Entity& e) {
-    auto anim_idx = (u32)Enemy_Anim::Knocked_Down;
-    if (e.extra_enemy.type == Enemy_Type::Boss) anim_idx = (u32)Enemy_Boss_Anim::Knocked_Down;
-    return { .anim_idx = anim_idx, .frame_duration_ms = 200 };
-}
-
-static Anim_Start_Opts enemy_get_anim_flying_back(const Entity& e) {
-    auto anim_idx = (u32)Enemy_Anim::Flying_Back;
-    if (e.extra_enemy.type == Enemy_Type::Boss) anim_idx = (u32)Enemy_Boss_Anim::Flying_Back;
-    return { .anim_idx = anim_idx, .looping = true };
-}
-
-static Anim_Start_Opts enemy_get_anim_got_hit(const Entity& e) {
-    auto anim_idx = (u32)Enemy_Anim::Got_Hit;
-    if (e.extra_enemy.type == Enemy_Type::Boss) {
-        anim_idx = (u32)Enemy_Boss_Anim::Got_Hit;
-    }
-    return { .anim_idx = anim_idx, .frame_duration_ms = 75 };
-}
-
-static Anim_Start_Opts enemy_get_anim_standing(const Entity& e) {
-    auto anim_idx = (u32)Enemy_Anim::Standing;
-    if (e.extra_enemy.type == Enemy_Type::Boss) {
-        anim_idx = (u32)Enemy_Boss_Anim::Guard_Standing;
-    }
-    return { .anim_idx = anim_idx, .frame_duration_ms = 75, .looping = true };
-}
-
-static Anim_Start_Opts enemy_get_anim_running(const Entity& e) {
-    auto anim_idx = (u32)Enemy_Anim::Running;
-    if (e.extra_enemy.type == Enemy_Type::Boss) {
-        anim_idx = (u32)Enemy_Boss_Anim::Guard_Running;
-    }
-    return { .anim_idx = anim_idx, .frame_duration_ms = 75, .looping = true };
-}
-
-static Anim_Start_Opts enemy_get_anim_punch_left(const Entity& e) {
-    auto anim_idx = (u32)Enemy_Anim::Punch_Left;
-    if (e.extra_enemy.type == Enemy_Type::Boss) {
-        anim_idx = (u32)Enemy_Boss_Anim::Punch_Left;
-    }
-    return { .anim_idx = anim_idx, .frame_duration_ms = 90 };
-}
-
-static Anim_Start_Opts enemy_get_anim_punch_right(const Entity& e) {
-    auto anim_idx = (u32)Enemy_Anim::Punch_Right;
-    if (e.extra_enemy.type == Enemy_Type::Boss) {
-        anim_idx = (u32)Enemy_Boss_Anim::Punch_Right;
-    }
-    return { .anim_idx = anim_idx, .frame_duration_ms = 100 };
-}
-
-static Anim_Start_Opts enemy_get_anim_flying_kick(const Entity& e) {
-    assert(e.extra_enemy.type == Enemy_Type::Boss);
-    return { .anim_idx = (u32)Enemy_Boss_Anim::Kick, .frame_duration_ms = 100 };
-}
-
-static Anim_Start_Opts enemy_get_anim_picking_up(const Entity& e) {
-    auto anim_idx = (u32)Enemy_Anim::Landing;
-    if (e.extra_enemy.type == Enemy_Type::Boss) {
-        anim_idx = (u32)Enemy_Boss_Anim::Landing;
-    }
-    return { .anim_idx = anim_idx };
-}
-
-static Anim_Start_Opts enemy_get_anim_standing_up(const Entity& e) {
-    auto anim_idx          = (u32)Enemy_Anim::Landing;
-    u64  frame_duration_ms = 500;
-
-    if (e.extra_enemy.type == Enemy_Type::Boss) {
-        anim_idx          = (u32)Enemy_Boss_Anim::Landing;
-        frame_duration_ms = 2000;
-    }
-
-    return { .anim_idx = anim_idx, .frame_duration_ms = frame_duration_ms };
+// the boss has its own sheet, so every clip comes in two versions
+static Clip_Id enemy_clip(const Entity& e, Clip_Id normal, Clip_Id boss) {
+    return e.extra_enemy.type == Enemy_Type::Boss ? boss : normal;
 }
 
 
@@ -178,14 +115,12 @@ static void enemy_make_stationary(Entity& e) {
 
 static void enemy_stand(Entity& e) {
     e.extra_enemy.state = Enemy_State::Standing;
-    auto opts = enemy_get_anim_standing(e);
-    animation_start(e.anim, opts);
+    animation_play(e.anim, enemy_clip(e, Clip_Id::Enemy_Standing, Clip_Id::Boss_Guard_Standing));
 }
 
 static void enemy_run(Entity& e) {
     e.extra_enemy.state = Enemy_State::Running;
-    auto opts = enemy_get_anim_running(e);
-    animation_start(e.anim, opts);
+    animation_play(e.anim, enemy_clip(e, Clip_Id::Enemy_Running, Clip_Id::Boss_Guard_Running));
 }
 
 static bool enemy_is_close_to_target_pos(const Entity& e) {
@@ -193,6 +128,18 @@ static bool enemy_is_close_to_target_pos(const Entity& e) {
     return enemy_pos.within_len_from(e.extra_enemy.target_pos, 0.3f);
 }
 
+static bool enemy_is_holding_something(const Entity& e) {
+    return e.extra_enemy.has_knife || e.extra_enemy.has_gun;
+}
+
+// enemies waiting in the outer rings only get in position, they are too far to hit anything
+static bool enemy_can_attack_from_slot(const Entity& e) {
+    return e.extra_enemy.slot == SLOT_NONE
+        || attack_slot_is_inner(e.extra_enemy.slot)
+        || e.extra_enemy.has_knife
+        || e.extra_enemy.has_gun;
+}
+
 static void enemy_get_ready_to_attack(Entity& e, const Game& g) {
     e.extra_enemy.ready_to_attack_timestamp = g.time_ms;
     e.extra_enemy.state = Enemy_State::In_Position_For_Attack;
@@ -200,7 +147,7 @@ static void enemy_get_ready_to_attack(Entity& e, const Game& g) {
 
 static void enemy_handle_movement(Entity& e, const Entity& player, const Game& g) {
     if (e.health <= 0) return;
-    if (e.extra_enemy.type != Enemy_Type::Boss && e.extra_enemy.slot == Slot::None) return;
+    if (e.extra_enemy.type != Enemy_Type::Boss && e.extra_enemy.slot == SLOT_NONE) return;
 
     const auto enemy_pos = entity_get_pos(e);
     const auto player_pos = entity_get_pos(player);
@@ -208,7 +155,7 @@ static void enemy_handle_movement(Entity& e, const Entity& player, const Game& g
         enemy_rotate_towards_player(e, enemy_pos, player_pos);
         enemy_make_stationary(e);
         if (e.extra_enemy.state != Enemy_State::Standing) enemy_stand(e);
-        enemy_get_ready_to_attack(e, g);
+        if (enemy_can_attack_from_slot(e)) enemy_get_ready_to_attack(e, g);
     } else {
         auto dir = e.extra_enemy.target_pos - enemy_pos;
         e.dir = dir_for_dir_vec(dir);
@@ -216,12 +163,34 @@ static void enemy_handle_movement(Entity& e, const Entity& player, const Game& g
             enemy_rotate_towards_player(e, enemy_pos, player_pos);
         }
 
-        dir.normalize();
-        e.x_vel = dir.x * e.speed;
-        e.y_vel = dir.y * e.speed;
+        // the crowd gives way less and less the closer the enemy is to its target, otherwise
+        // neighbouring slots would keep pushing each other out of position
+        const f32 distance   = dir.len();
+        const f32 separation = settings.steering_separation_weight * std::min(1.0f, distance / settings.steering_arrive_radius);
+        auto vel = steering_arrive(enemy_pos, e.extra_enemy.target_pos, e.speed, settings.steering_arrive_radius);
+        // far from the slot the shared flow field knows the way around obstacles, close to it the slot is
+        // right next to the player anyway, enemies with weapons keep their distance so they dont follow it
+        if (distance > settings.flow_field_direct_distance && !enemy_is_holding_something(e)) {
+            if (auto flow = flow_field_sample(g.flow, enemy_pos)) vel = *flow * e.speed;
+        }
+        vel += steering_separation(e, g, settings.steering_separation_radius, e.speed) * separation;
+        vel = steering_clamp(vel, e.speed);
+        e.x_vel = vel.x;
+        e.y_vel = vel.y;
     }
 
     auto collided_with = entity_movement_handle_collisions_and_pos_change(e, &g, collide_opts);
+    if (collided_with != Collision_Type::None) {
+        // slide along whatever is in the way, one axis at a time, before giving up
+        const Vec2<f32> vel = {e.x_vel, e.y_vel};
+        e.y_vel = 0.0f;
+        collided_with = entity_movement_handle_collisions_and_pos_change(e, &g, collide_opts);
+        if (collided_with != Collision_Type::None) {
+            e.x_vel = 0.0f;
+            e.y_vel = vel.y;
+            collided_with = entity_movement_handle_collisions_and_pos_change(e, &g, collide_opts);
+        }
+    }
     if (collided_with != Collision_Type::None) {
         enemy_rotate_towards_player(e, enemy_pos, player_pos);
         enemy_stand(e);
@@ -240,12 +209,11 @@ static void enemy_get_knocked_down(Entity& e, Direction dmg_dir) {
     }
 
     e.extra_enemy.state = Enemy_State::Knocked_Down;
-    auto opts = enemy_get_anim_knocked_down(e);
-    animation_start(e.anim, opts);
+    animation_play(e.anim, enemy_clip(e, Clip_Id::Enemy_Knocked_Down, Clip_Id::Boss_Knocked_Down));
 }
 
 // returns wheter got hit
-static bool enemy_receive_damage(Entity& e) {
+static bool enemy_receive_damage(Entity& e, Game& g) {
     if (e.health <= 0.0f) return false;
     auto got_hit = false;
     Dmg most_significant_dmg = {};
@@ -269,13 +237,13 @@ static bool enemy_receive_damage(Entity& e) {
     if (got_hit) {
         e.extra_enemy.state = Enemy_State::Got_Hit;
         e.extra_enemy.can_spawn_knives = false;
+        entity_emit_hit_sparks(e, g, e.damage_queue.back().going_to, settings.spark_count_hit);
 
         using enum Hit_Type;
         switch (most_significant_dmg.type) {
             case Normal: {
                 if (e.extra_enemy.type != Enemy_Type::Boss) {
-                    auto opts = enemy_get_anim_got_hit(e);
-                    animation_start(e.anim, opts);
+                    animation_play(e.anim, Clip_Id::Enemy_Got_Hit);
                 }
             } break;
 
@@ -293,8 +261,7 @@ static bool enemy_receive_damage(Entity& e) {
                 }
 
                 e.extra_enemy.state = Enemy_State::Flying_Back;
-                auto opts = enemy_get_anim_flying_back(e);
-                animation_start(e.anim, opts);
+                animation_play(e.anim, enemy_clip(e, Clip_Id::Enemy_Flying_Back, Clip_Id::Boss_Flying_Back));
             } break;
         }
     }
@@ -323,9 +290,10 @@ static void enemy_handle_flying_back_collateral_dmg(Entity& e, Game& g) {
 
     for (auto& other_e : g.entities) {
         if (e.handle == other_e.handle) continue;
+        if (other_e.sleeping)           continue;
 
         SDL_FRect other_e_hitbox = entity_get_world_hitbox(other_e);
-        if (SDL_HasRectIntersectionFloat(&hitbox_box, &other_e_hitbox)) {
+        if (entity_boxes_intersect(hitbox_box, other_e_hitbox)) {
             auto dir = Direction::Left;
             if (e.dir == Direction::Left) {
                 dir = Direction::Right;
@@ -349,20 +317,21 @@ static bool enemy_handle_flying_back(Entity& e, const Game& g) {
     return collided_with != Collision_Type::None;
 }
 
-static void enemy_claim_slot(Entity& e, const Entity& player, Game& g) {
-    const auto slots = player.extra_player.slots;
-    const auto empty_slot = find_empty_slot(slots);
-    if (empty_slot != Slot::None) {
-        e.extra_enemy.target_pos = claim_slot_position(g, empty_slot);
-        e.extra_enemy.slot = empty_slot;
+static void enemy_claim_slot(Entity& e, Game& g) {
+    auto& slots = game_get_player_mutable(g).extra_player.slots;
+    const auto slot = attack_slots_claim(slots, entity_get_pos(e));
+    if (slot != SLOT_NONE) {
+        e.extra_enemy.target_pos = slots.world[slot];
+        e.extra_enemy.slot = slot;
         enemy_run(e);
     }
 }
 
 static void enemy_return_claimed_slot(Entity& e, Game& g) {
-    if (e.extra_enemy.slot == Slot::None) unreachable("we shouldnt ever hit this code path if slot is invalid");
+    if (e.extra_enemy.slot == SLOT_NONE) unreachable("we shouldnt ever hit this code path if slot is invalid");
 
-    return_claimed_slot(g, e.extra_enemy.slot);
+    attack_slots_return(game_get_player_mutable(g).extra_player.slots, e.extra_enemy.slot);
+    e.extra_enemy.slot = SLOT_NONE;
 }
 
 static void enemy_update_target_pos(Entity& e, const Entity& player, const Game& g) {
@@ -403,8 +372,8 @@ static void enemy_update_target_pos(Entity& e, const Entity& player, const Game&
         return;
     }
 
-    if (e.extra_enemy.slot != Slot::None) {
-        e.extra_enemy.target_pos = calc_world_coordinates_of_slot({player.x, player.y}, player.extra_player.slots, e.extra_enemy.slot);
+    if (e.extra_enemy.slot != SLOT_NONE) {
+        e.extra_enemy.target_pos = player.extra_player.slots.world[e.extra_enemy.slot];
         return;
     }
 }
@@ -450,31 +419,44 @@ static bool enemy_can_attack(const Entity& e, const Game& g) {
         && s != Enemy_State::Running
         && s != Enemy_State::Attacking
         && enemy_is_close_to_target_pos(e)
+        && enemy_can_attack_from_slot(e)
         && enemy_attack_timed_out(e, g);
 }
 
-static void enemy_deal_damage(Entity& e, Game& g, Hit_Type hit_type = Hit_Type::Normal) {
+static void enemy_deal_damage(Entity& e, Game& g, const SDL_FRect& enemy_hurtbox, Hit_Type hit_type = Hit_Type::Normal) {
     auto& player = game_get_player_mutable(g);
     auto player_hitbox = entity_get_world_hitbox(player);
-    auto enemy_hurtbox = entity_get_world_hurtbox(e);
-    if (SDL_HasRectIntersectionFloat(&player_hitbox, &enemy_hurtbox)) {
+    if (entity_boxes_intersect(player_hitbox, enemy_hurtbox)) {
         player.damage_queue.push_back({e.damage, e.dir, hit_type});
     }
 }
 
+// Lands the pending attack on the first frame of its clip that has a hurtbox,
+// frames without one dont query the player at all.
+static void enemy_handle_pending_attack(Entity& e, Game& g) {
+    if (!e.extra_enemy.attack_pending) return;
+
+    const auto hurtbox = entity_get_world_hurtbox(e);
+    if (!hurtbox) return;
+
+    e.extra_enemy.attack_pending = false;
+    enemy_deal_damage(e, g, *hurtbox);
+}
+
 static void enemy_attack(Entity& e, Game& g) {
     e.extra_enemy.state = Enemy_State::Attacking;
-    Anim_Start_Opts opts = {};
+    e.extra_enemy.attack_pending = false;
+    const auto clip_punch_left  = enemy_clip(e, Clip_Id::Enemy_Punch_Left,  Clip_Id::Boss_Punch_Left);
+    const auto clip_punch_right = enemy_clip(e, Clip_Id::Enemy_Punch_Right, Clip_Id::Boss_Punch_Right);
     if (e.extra_enemy.has_knife) {
-        opts = enemy_get_anim_punch_right(e);
-        animation_start(e.anim, opts);
+        animation_play(e.anim, clip_punch_right);
         e.extra_enemy.has_knife = false;
+        entity_weapon_lost(e, g, Collectible_Type::Knife);
         collectible_throw(Collectible_Type::Knife, g, e);
         return;
     } else if (e.extra_enemy.has_gun) {
-        opts = enemy_get_anim_punch_left(e);
-        animation_start(e.anim, opts);
-        bullet_init(g, {
+        animation_play(e.anim, clip_punch_left);
+        spawn_bullet(g, {
             .pos_creator = entity_get_pos(e),
             .offsets     = e.bullet_start_offsets,
             .dir         = e.dir,
@@ -483,26 +465,25 @@ static void enemy_attack(Entity& e, Game& g) {
         return;
     }
 
+    auto clip = clip_punch_left;
     auto attack_anim = e.extra_enemy.idx_attack % 2;
     switch (attack_anim) {
         case 0: {
-            opts = enemy_get_anim_punch_left(e);
+            clip = clip_punch_left;
         } break;
 
         case 1: {
-            opts = enemy_get_anim_punch_right(e);
+            clip = clip_punch_right;
         } break;
     }
 
     if (e.extra_enemy.type == Enemy_Type::Boss) {
-        opts = enemy_get_anim_flying_kick(e);
-        animation_start(e.anim, opts);
+        animation_play(e.anim, Clip_Id::Boss_Flying_Kick);
         return;
     }
 
-    enemy_deal_damage(e, g);
-
-    animation_start(e.anim, opts);
+    animation_play(e.anim, clip);
+    e.extra_enemy.attack_pending = true;
     e.extra_enemy.idx_attack++;
     e.extra_enemy.last_attack_timestamp = g.time_ms;
 }
@@ -511,6 +492,7 @@ static void enemy_drop_knife(Entity& e, Game& g) {
     if (e.extra_enemy.has_knife) {
         collectible_drop(Collectible_Type::Knife, g, e);
         e.extra_enemy.has_knife = false;
+        entity_weapon_lost(e, g, Collectible_Type::Knife);
     }
 }
 
@@ -518,22 +500,20 @@ static void enemy_drop_gun(Entity& e, Game& g) {
     if (e.extra_enemy.has_gun) {
         collectible_drop(Collectible_Type::Gun, g, e);
         e.extra_enemy.has_gun = false;
+        entity_weapon_lost(e, g, Collectible_Type::Gun);
     }
 }
 
-static void enemy_respawn_knife(Entity& e, const Game& g) {
+static void enemy_respawn_knife(Entity& e, Game& g) {
     if (e.extra_enemy.has_knife)         return;
     if (!e.extra_enemy.can_spawn_knives) return;
 
     if (enemy_attack_timed_out(e, g)) {
         e.extra_enemy.has_knife = true;
+        entity_weapon_gained(e, g, Collectible_Type::Knife);
     }
 }
 
-static bool enemy_is_holding_something(const Entity& e) {
-    return e.extra_enemy.has_knife || e.extra_enemy.has_gun;
-}
-
 static bool enemy_can_pick_up_collectible(const Entity& e, Game& g) {
     if (enemy_is_holding_something(e)) return false;
 
@@ -553,10 +533,12 @@ static void enemy_pick_up_collectible(Entity& e, Game& g) {
     switch (collectible->extra_collectible.type) {
         case Collectible_Type::Knife: {
             e.extra_enemy.has_knife = true;
+            entity_weapon_gained(e, g, Collectible_Type::Knife);
         } break;
 
         case Collectible_Type::Gun: {
             e.extra_enemy.has_gun = true;
+            entity_weapon_gained(e, g, Collectible_Type::Gun);
         } break;
 
         case Collectible_Type::Food: {
@@ -564,7 +546,7 @@ static void enemy_pick_up_collectible(Entity& e, Game& g) {
         } break;
     }
 
-    animation_start(e.anim, enemy_get_anim_picking_up(e));
+    animation_play(e.anim, enemy_clip(e, Clip_Id::Enemy_Picking_Up, Clip_Id::Boss_Picking_Up));
     e.extra_enemy.state = Enemy_State::Picking_Up_Collectible;
 }
 
@@ -577,28 +559,50 @@ Collision_Type enemy_boss_handle_collisions_and_pos_change(Entity& e, const Game
     return entity_movement_handle_collisions_and_pos_change(e, &g, collide_opts_flying_boss);
 }
 
+static bool enemy_is_engaged(const Entity& e, const Entity& player, const Game& g) {
+    if (e.extra_enemy.type == Enemy_Type::Boss)   return true;
+    if (attack_slot_is_inner(e.extra_enemy.slot)) return true;
+
+    const bool on_screen = e.x >= g.camera.x && e.x <= g.camera.x + g.camera.w;
+    if (!on_screen) return false;
+    if (enemy_is_holding_something(e)) return true;
+
+    const auto to_player = entity_get_pos(player) - entity_get_pos(e);
+    return to_player.x*to_player.x + to_player.y*to_player.y <= settings.enemy_engaged_distance * settings.enemy_engaged_distance;
+}
+
+// Enemies that are fighting the player from an inner slot decide every tick, the ones waiting in an
+// outer ring or for a slot at all, and the ones off screen, only every few ticks. The handle offsets
+// the tick, so that they dont all decide on the same one.
+static bool enemy_should_think(const Entity& e, const Entity& player, const Game& g) {
+    const u64 interval = enemy_is_engaged(e, player, g) ? settings.enemy_think_interval_engaged : settings.enemy_think_interval_queued;
+    if (interval <= 1) return true;
+    return (g.tick + e.handle.id) % interval == 0;
+}
+
 Update_Result enemy_update(Entity& e, const Entity& player, Game& g) {
     assert(e.type == Entity_Type::Enemy);
 
-    animation_update(e.anim, g.dt, g.dt_real);
-
-    enemy_update_target_pos(e, player, g);
+    const bool think = enemy_should_think(e, player, g);
+    if (think) enemy_update_target_pos(e, player, g);
 
     if (enemy_can_move(e)) {
-        if (enemy_can_pick_up_collectible(e, g)) {
-            if (e.extra_enemy.slot != Slot::None) {
+        if (!think) {
+            // keeps going towards the target from the last decision
+        } else if (enemy_can_pick_up_collectible(e, g)) {
+            if (e.extra_enemy.slot != SLOT_NONE) {
                 enemy_return_claimed_slot(e, g);
             }
             enemy_pick_up_collectible(e, g);
-        } else if (e.extra_enemy.type != Enemy_Type::Boss && e.extra_enemy.slot == Slot::None) {
-            enemy_claim_slot(e, player, g);
+        } else if (e.extra_enemy.type != Enemy_Type::Boss && e.extra_enemy.slot == SLOT_NONE) {
+            enemy_claim_slot(e, g);
         }
 
         enemy_handle_movement(e, player, g);
     }
 
     if (enemy_can_receive_damage(e)) {
-        auto got_hit = enemy_receive_damage(e);
+        auto got_hit = enemy_receive_damage(e, g);
         if (got_hit) {
             enemy_drop_knife(e, g);
             enemy_drop_gun(e, g);
@@ -643,7 +647,11 @@ Update_Result enemy_update(Entity& e, const Entity& player, Game& g) {
                     } break;
 
                     case Player: {
-                        auto p = game_get_player(g);
+                        // The kick only connects on the frames where it has a hurtbox, touching the player
+                        // during the wind up keeps the boss flying into them until the kick lands.
+                        if (!entity_get_world_hurtbox(e)) break;
+
+                        auto& p = game_get_player_mutable(g);
                         p.damage_queue.push_back({e.damage, e.dir, Hit_Type::Knockdown});
                         enemy_stand(e);
                     } break;
@@ -652,6 +660,8 @@ Update_Result enemy_update(Entity& e, const Entity& player, Game& g) {
                 }
 
             } else {
+                enemy_handle_pending_attack(e, g);
+
                 if (animation_is_finished(e.anim)) {
                     enemy_stand(e);
                 }
@@ -662,10 +672,8 @@ Update_Result enemy_update(Entity& e, const Entity& player, Game& g) {
             const auto knockback_finished = enemy_handle_knockback(e, g);
             const auto anim_finished = animation_is_finished(e.anim);
             if (knockback_finished && anim_finished && e.health <= 0.0f) {
-                auto opts = enemy_get_anim_knocked_down(e);
-                opts.fadeout = { .enabled = true, .perc_per_sec = 0.8f };
                 e.extra_enemy.state = Enemy_State::Dying;
-                animation_start(e.anim, opts);
+                animation_play(e.anim, enemy_clip(e, Clip_Id::Enemy_Dying, Clip_Id::Boss_Dying));
             } else if (knockback_finished && anim_finished) {
                 enemy_stand(e);
             }
@@ -679,50 +687,28 @@ Update_Result enemy_update(Entity& e, const Entity& player, Game& g) {
                 // this makes them bounce off of the wall
                 e.x_vel = -e.x_vel;
                 e.extra_enemy.state = Enemy_State::Knocked_Down;
-                auto opts = enemy_get_anim_knocked_down(e);
-                animation_start(e.anim, opts);
+                animation_play(e.anim, enemy_clip(e, Clip_Id::Enemy_Knocked_Down, Clip_Id::Boss_Knocked_Down));
             }
         } break;
 
         case Knocked_Down: {
-            auto anim_idx = (u32)Enemy_Anim::On_The_Ground;
-            if (e.extra_enemy.type == Enemy_Type::Boss) {
-                anim_idx = (u32)Enemy_Boss_Anim::On_The_Ground;
-            }
-
             const auto knockback_finished = enemy_handle_knockback(e, g);
             const auto anim_finished = animation_is_finished(e.anim);
 
             if (knockback_finished && anim_finished && e.health <= 0.0f) {
                 e.extra_enemy.state = Enemy_State::Dying;
-
-                animation_start(
-                    e.anim,
-                    {
-                        .anim_idx          = anim_idx,
-                        .frame_duration_ms = 200,
-                        .fadeout           = { .enabled = true, .perc_per_sec = 0.8f },
-                    }
-                );
+                animation_play(e.anim, enemy_clip(e, Clip_Id::Enemy_Dying_On_The_Ground, Clip_Id::Boss_Dying_On_The_Ground));
             }
             else if (knockback_finished && anim_finished) {
                 e.extra_enemy.state = Enemy_State::On_The_Ground;
-
-                animation_start(
-                    e.anim,
-                    {
-                        .anim_idx          = anim_idx,
-                        .frame_duration_ms = 750,
-                    }
-                );
+                animation_play(e.anim, enemy_clip(e, Clip_Id::Enemy_On_The_Ground, Clip_Id::Boss_On_The_Ground));
             }
         } break;
 
         case On_The_Ground: {
             if (animation_is_finished(e.anim)) {
                 e.extra_enemy.state = Enemy_State::Standing_Up;
-                auto opts = enemy_get_anim_standing_up(e);
-                animation_start(e.anim, opts);
+                animation_play(e.anim, enemy_clip(e, Clip_Id::Enemy_Standing_Up, Clip_Id::Boss_Standing_Up));
             }
         } break;
 
@@ -740,7 +726,7 @@ Update_Result enemy_update(Entity& e, const Entity& player, Game& g) {
 
         case Dying: {
             if (animation_is_finished(e.anim)) {
-                if (e.extra_enemy.slot != Slot::None) enemy_return_claimed_slot(e, g);
+                if (e.extra_enemy.slot != SLOT_NONE) enemy_return_claimed_slot(e, g);
                 return Update_Result::Remove_Me;
             }
         } break;
@@ -1,10 +1,14 @@
+#include <bit>
 #include <cassert>
+#include <cmath>
+#include <numbers>
 
 #include "entity.h"
 #include "../settings.h"
 #include "../draw.h"
 #include "../utils.h"
 #include "../game.h"
+#include "../perf.h"
 
 Vec2<f32> entity_offset_to_bottom_center(const Entity& e) {
     return {e.x - e.sprite_frame_w / 2, e.y - e.sprite_frame_h};
@@ -23,22 +27,58 @@ SDL_FRect entity_get_world_collision_box(const Entity& e) {
     };
 }
 
-SDL_FRect entity_get_world_hurtbox(const Entity& e) {
+// boxes in the clip table are for an entity facing right
+static SDL_FRect entity_offsets_facing(const Entity& e, SDL_FRect offsets) {
+    if (e.dir == Direction::Left) offsets.x = -offsets.x - offsets.w;
+    return offsets;
+}
+
+static SDL_FRect entity_offsets_to_world(const Entity& e, const SDL_FRect& offsets) {
     return {
-        e.x + e.hurtbox_offsets.x,
-        e.y + e.z + e.hurtbox_offsets.y,
-        e.hurtbox_offsets.w,
-        e.hurtbox_offsets.h
+        e.x + offsets.x,
+        e.y + e.z + offsets.y,
+        offsets.w,
+        offsets.h
     };
 }
 
+SDL_FRect entity_get_hitbox_offsets(const Entity& e) {
+    const auto* box = clip_find_box(e.anim.clip, Clip_Box_Kind::Hit, animation_frame(e.anim));
+    if (box) return entity_offsets_facing(e, *box);
+    return e.hitbox_offsets;
+}
+
+std::optional<SDL_FRect> entity_get_hurtbox_offsets(const Entity& e) {
+    // thrown props keep their static box for as long as they fly
+    if (e.anim.clip == CLIP_NONE) return e.hurtbox_offsets;
+
+    const auto* box = clip_find_box(e.anim.clip, Clip_Box_Kind::Hurt, animation_frame(e.anim));
+    if (!box) return std::nullopt;
+    return entity_offsets_facing(e, *box);
+}
+
 SDL_FRect entity_get_world_hitbox(const Entity& e) {
-    return {
-        e.x + e.hitbox_offsets.x,
-        e.y + e.z + e.hitbox_offsets.y,
-        e.hitbox_offsets.w,
-        e.hitbox_offsets.h
-    };
+    return entity_offsets_to_world(e, entity_get_hitbox_offsets(e));
+}
+
+std::optional<SDL_FRect> entity_get_world_hurtbox(const Entity& e) {
+    const auto offsets = entity_get_hurtbox_offsets(e);
+    if (!offsets) return std::nullopt;
+    return entity_offsets_to_world(e, *offsets);
+}
+
+void entity_emit_hit_sparks(const Entity& e, Game& g, Direction dir, u64 count) {
+    const auto hitbox = entity_get_world_hitbox(e);
+    particles_emit_sparks(g.particles, {
+        .pos   = {hitbox.x + hitbox.w / 2, hitbox.y + hitbox.h / 2},
+        .dir   = dir,
+        .count = count,
+    });
+}
+
+bool entity_boxes_intersect(const SDL_FRect& a, const SDL_FRect& b) {
+    perf.frame.collision_tests++;
+    return SDL_HasRectIntersectionFloat(&a, &b);
 }
 
 void entity_draw(SDL_Renderer* r, const Entity& e, const Game* g) {
@@ -55,11 +95,11 @@ void entity_draw(SDL_Renderer* r, const Entity& e, const Game* g) {
         {
             .x_dst        = screen_coords.x,
             .y_dst        = screen_coords.y,
-            .row          = e.anim.frames.idx,
-            .col          = e.anim.frames.frame_current,
+            .row          = e.anim.row,
+            .col          = animation_frame(e.anim),
             .flip         = flip,
-            .opacity      = e.anim.fadeout.perc_visible_curr,
-            .rotation_deg = e.anim.rotation.deg_curr,
+            .opacity      = animation_opacity(e.anim),
+            .rotation_deg = animation_rotation_deg(e.anim),
         }
     );
     if (!ok) SDL_Log("Failed to draw enemy sprite! SDL err: %s\n", SDL_GetError());
@@ -71,7 +111,7 @@ void entity_draw(SDL_Renderer* r, const Entity& e, const Game* g) {
             .world_coords   = world_coords,
             .shadow_offsets = e.shadow_offsets,
             .g              = *g,
-            .opacity        = e.anim.fadeout.perc_visible_curr
+            .opacity        = animation_opacity(e.anim)
         }
     );
 
@@ -81,8 +121,11 @@ void entity_draw(SDL_Renderer* r, const Entity& e, const Game* g) {
         world_coords.y += e.z;
 
         if (settings.show_collision_boxes) draw_collision_box(r, world_coords, e.collision_box_offsets, *g);
-        if (settings.show_hurtboxes) draw_hurtbox(r, world_coords, e.hurtbox_offsets, *g);
-        if (settings.show_hitboxes) draw_hitbox(r, world_coords, e.hitbox_offsets, *g);
+        if (settings.show_hurtboxes) {
+            const auto hurtbox_offsets = entity_get_hurtbox_offsets(e);
+            if (hurtbox_offsets) draw_hurtbox(r, world_coords, *hurtbox_offsets, *g);
+        }
+        if (settings.show_hitboxes) draw_hitbox(r, world_coords, entity_get_hitbox_offsets(e), *g);
         if (settings.show_sprite_debug) {
             SDL_FRect sprite_bounds_screen = {
                 screen_coords.x,
@@ -116,16 +159,18 @@ void entity_draw_knife(SDL_Renderer* r, const Entity& e, Game* g) {
 
     const Sprite* s = &g->sprite_knife_player;
     if (e.type == Entity_Type::Enemy) s = &g->sprite_knife_enemy;
+    // loaded when the weapon was gained, nothing gets loaded while drawing
+    if (!s->img.img) return;
     bool ok = sprite_draw_at_dst(
         *s,
         r,
         {
             .x_dst                         = screen_coords.x,
             .y_dst                         = screen_coords.y,
-            .row                           = e.anim.frames.idx,
-            .col                           = e.anim.frames.frame_current,
+            .row                           = e.anim.row,
+            .col                           = animation_frame(e.anim),
             .flip                          = flip,
-            .opacity                       = e.anim.fadeout.perc_visible_curr,
+            .opacity                       = animation_opacity(e.anim),
             .center_of_rotation_offsets    = &game_get_mutable_entity_by_handle(*g, e.handle)->rotation_center_offsets,
             .return_on_failed_range_checks = true,
         }
@@ -144,16 +189,17 @@ void entity_draw_gun(SDL_Renderer* r, const Entity& e, Game* g) {
 
     const Sprite* s = &g->sprite_gun_player;
     if (e.type == Entity_Type::Enemy) s = &g->sprite_gun_enemy;
+    if (!s->img.img) return;
     bool ok = sprite_draw_at_dst(
         *s,
         r,
         {
             .x_dst                         = screen_coords.x,
             .y_dst                         = screen_coords.y,
-            .row                           = e.anim.frames.idx,
-            .col                           = e.anim.frames.frame_current,
+            .row                           = e.anim.row,
+            .col                           = animation_frame(e.anim),
             .flip                          = flip,
-            .opacity                       = e.anim.fadeout.perc_visible_curr,
+            .opacity                       = animation_opacity(e.anim),
             .center_of_rotation_offsets    = &game_get_mutable_entity_by_handle(*g, e.handle)->rotation_center_offsets,
             .return_on_failed_range_checks = true,
         }
@@ -161,6 +207,17 @@ void entity_draw_gun(SDL_Renderer* r, const Entity& e, Game* g) {
     if (!ok) SDL_Log("Failed to draw enemy sprite! SDL err: %s\n", SDL_GetError());
 }
 
+void entity_weapon_gained(const Entity& holder, Game& g, Collectible_Type weapon) {
+    const Sheet sheet = sheet_of_weapon(holder.type, weapon);
+    sheet_acquire(g, sheet);
+    // logged once here, the weapon just isnt drawn then
+    if (!sheet_require(g, sheet)) SDL_Log("Weapon gained without its sheet!\n");
+}
+
+void entity_weapon_lost(const Entity& holder, Game& g, Collectible_Type weapon) {
+    sheet_release(g, sheet_of_weapon(holder.type, weapon));
+}
+
 Collision_Type entity_movement_handle_collisions_and_pos_change(Entity& e, const Game* g, Collide_Opts opts) {
     assert(g != nullptr);
 
@@ -173,9 +230,14 @@ Collision_Type entity_movement_handle_collisions_and_pos_change(Entity& e, const
     Collision_Type collided_with = None;
     SDL_FRect entity_collision_box = entity_get_world_collision_box(e);
 
+    // nothing walks or flies through the static geometry, the borders depend on the type below
+    if (level_bvh_intersects(g->level_bvh, entity_collision_box)) {
+        collided_with = Wall;
+    }
+
     if (e.type == Entity_Type::Player) {
         for (const auto& box : level_info_get_collision_boxes(g->curr_level_info)) {
-            if (SDL_HasRectIntersectionFloat(&box, &entity_collision_box)) {
+            if (entity_boxes_intersect(box, entity_collision_box)) {
                 collided_with = Wall;
                 break;
             }
@@ -184,7 +246,7 @@ Collision_Type entity_movement_handle_collisions_and_pos_change(Entity& e, const
 
     if (e.type == Entity_Type::Enemy) {
         const auto& box = level_info_get_collision_box(g->curr_level_info, Border::Top);
-        if (SDL_HasRectIntersectionFloat(&box, &entity_collision_box)) {
+        if (entity_boxes_intersect(box, entity_collision_box)) {
             collided_with = Wall;
         }
     }
@@ -192,15 +254,15 @@ Collision_Type entity_movement_handle_collisions_and_pos_change(Entity& e, const
     if (e.type == Entity_Type::Collectible) {
         const auto& box_right = level_info_get_collision_box(g->curr_level_info, Border::Right);
         const auto& box_left = level_info_get_collision_box(g->curr_level_info, Border::Left);
-        if (SDL_HasRectIntersectionFloat(&box_right, &entity_collision_box)
-            || SDL_HasRectIntersectionFloat(&box_left, &entity_collision_box)) {
+        if (entity_boxes_intersect(box_right, entity_collision_box)
+            || entity_boxes_intersect(box_left, entity_collision_box)) {
             collided_with = Wall;
         }
     }
 
     if (opts.collide_with_walls) {
         for (const auto& box : level_info_get_collision_boxes(g->curr_level_info)) {
-            if (SDL_HasRectIntersectionFloat(&box, &entity_collision_box)) {
+            if (entity_boxes_intersect(box, entity_collision_box)) {
                 collided_with = Wall;
                 break;
             }
@@ -208,47 +270,51 @@ Collision_Type entity_movement_handle_collisions_and_pos_change(Entity& e, const
     }
 
     if (collided_with == None) {
-        for (const auto& e_other : g->entities) {
-            if (e.handle == e_other.handle) continue;
-            auto skip = false;
+        // the grid only has candidates, of those the first one in g.entities wins like with a plain loop over them
+        const SDL_FRect area = {
+            entity_collision_box.x - SPATIAL_GRID_BOX_MARGIN,
+            entity_collision_box.y - SPATIAL_GRID_BOX_MARGIN,
+            entity_collision_box.w + 2*SPATIAL_GRID_BOX_MARGIN,
+            entity_collision_box.h + 2*SPATIAL_GRID_BOX_MARGIN,
+        };
+        u32 idx_hit = UINT32_MAX;
+        spatial_grid_query(g->grid, area, [&](u32 idx) {
+            if (idx >= idx_hit) return;
+
+            const auto& e_other = g->entities[idx];
+            if (e.handle == e_other.handle) return;
+            if (e_other.sleeping)           return;
             for (auto dont_with_type : opts.dont_collide_with) {
-                if (e_other.type == dont_with_type) {
-                    skip = true;
-                    break;
-                }
+                if (e_other.type == dont_with_type) return;
             }
-            if (skip) continue;
 
             const auto& e_box = entity_get_world_collision_box(e_other);
-            if (SDL_HasRectIntersectionFloat(&e_box, &entity_collision_box)) {
-                switch (e_other.type) {
-                    case Entity_Type::Player: {
-                        collided_with = Player;
-                    } break;
-
-                    case Entity_Type::Enemy: {
-                        collided_with = Enemy;
-                    } break;
-
-                    case Entity_Type::Collectible: {
-                        collided_with = Collectible;
-                    } break;
-
-                    case Entity_Type::Barrel: {
-                        collided_with = Barrel;
-                    } break;
-
-                    case Entity_Type::Bullet: {
-                        // ignore this one
-                    } break;
-
-                    default: {
-                        SDL_Log("Entity_Type: %d", e_other.type);
-                        unreachable("probably shouldnt happen, but idk");
-                    } break;
-                }
-
-                break;
+            if (entity_boxes_intersect(e_box, entity_collision_box)) idx_hit = idx;
+        });
+
+        if (idx_hit != UINT32_MAX) {
+            const auto& e_other = g->entities[idx_hit];
+            switch (e_other.type) {
+                case Entity_Type::Player: {
+                    collided_with = Player;
+                } break;
+
+                case Entity_Type::Enemy: {
+                    collided_with = Enemy;
+                } break;
+
+                case Entity_Type::Collectible: {
+                    collided_with = Collectible;
+                } break;
+
+                case Entity_Type::Barrel: {
+                    collided_with = Barrel;
+                } break;
+
+                default: {
+                    SDL_Log("Entity_Type: %d", e_other.type);
+                    unreachable("probably shouldnt happen, but idk");
+                } break;
             }
         }
     }
@@ -261,118 +327,102 @@ Collision_Type entity_movement_handle_collisions_and_pos_change(Entity& e, const
     return collided_with;
 }
 
-Vec2<f32> calc_world_coordinates_of_slot(Vec2<f32> player_world_pos, const Player_Attack_Slots& slots, Slot slot) {
-    switch (slot) {
-        case Slot::None: {
-            unreachable("coordinates can only be calculated for a valid slot");
-        } break;
-
-        case Slot::Top_Left: {
-            return player_world_pos + slots.offset_top_left;
-        } break;
-
-        case Slot::Top_Right: {
-            return player_world_pos + slots.offset_top_right;
-        } break;
-
-        case Slot::Bottom_Left: {
-            return player_world_pos + slots.offset_bottom_left;
-        } break;
-
-        case Slot::Bottom_Right: {
-            return player_world_pos + slots.offset_bottom_right;
-        } break;
+void attack_slots_init(Player_Attack_Slots& slots, Vec2<f32> player_world_pos) {
+    constexpr f32 pi = std::numbers::pi_v<f32>;
+
+    slots.free_mask = SLOT_COUNT == 32 ? UINT32_MAX : (1u << SLOT_COUNT) - 1;
+    for (u32 idx_ring = 0; idx_ring < std::size(slot_rings); idx_ring++) {
+        const auto& ring     = slot_rings[idx_ring];
+        const u32   per_side = ring.count / 2;
+        const u32   first    = slot_ring_first(idx_ring);
+
+        // within 45 degrees of the horizontal on each side, so that they face the player
+        for (u32 idx = 0; idx < per_side; idx++) {
+            const f32 angle = -pi/4 + (pi/2) * (idx + 0.5f) / per_side;
+            const f32 x     = std::cos(angle) * ring.radius_x;
+            const f32 y     = std::sin(angle) * ring.radius_y;
+            slots.offsets[first + 2*idx]     = {-x, y};
+            slots.offsets[first + 2*idx + 1] = { x, y};
+        }
     }
 
-    unreachable("just to make the compiler happy");
-    return {};
+    for (u32 idx = 0; idx < SLOT_COUNT; idx++) {
+        slots.world[idx] = player_world_pos + slots.offsets[idx];
+    }
 }
 
-Slot find_empty_slot(const Player_Attack_Slots& slots) {
-    auto result = Slot::None;
-
-    if (slots.top_right_free) {
-        result = Slot::Top_Right;
-    }
-    else if (slots.bottom_right_free) {
-        result = Slot::Bottom_Right;
-    }
-    else if (slots.top_left_free) {
-        result = Slot::Top_Left;
-    }
-    else if (slots.bottom_left_free) {
-        result = Slot::Bottom_Left;
+static Slot attack_slots_nearest_free(const Player_Attack_Slots& slots, u32 mask, Vec2<f32> pos) {
+    Slot nearest          = SLOT_NONE;
+    f32  nearest_distance = 0.0f;
+    for (u32 free = slots.free_mask & mask; free != 0; free &= free - 1) {
+        const Slot slot = std::countr_zero(free);
+        const auto diff = slots.world[slot] - pos;
+        const f32  distance = diff.x*diff.x + diff.y*diff.y;
+        if (nearest == SLOT_NONE || distance < nearest_distance) {
+            nearest          = slot;
+            nearest_distance = distance;
+        }
     }
-
-    return result;
+    return nearest;
 }
 
-Vec2<f32> claim_slot_position(Game& game, Slot slot) {
-    Entity& player = game_get_player_mutable(game);
-    const auto& slots = player.extra_player.slots;
-    const Vec2<f32> player_pos = {player.x, player.y};
-
-    switch (slot) {
-        case Slot::None: {
-            unreachable("only a valid position can be claimed");
-        } break;
+Slot attack_slots_claim(Player_Attack_Slots& slots, Vec2<f32> pos) {
+    for (u32 idx_ring = 0; idx_ring < std::size(slot_rings); idx_ring++) {
+        const Slot slot = attack_slots_nearest_free(slots, slot_ring_mask(idx_ring), pos);
+        if (slot == SLOT_NONE) continue;
 
-        case Slot::Top_Left: {
-            if (slots.top_left_free) {
-                player.extra_player.slots.top_left_free = false;
-                return calc_world_coordinates_of_slot(player_pos, slots, slot);
-            }
-        } break;
-
-        case Slot::Top_Right: {
-            if (slots.top_right_free) {
-                player.extra_player.slots.top_right_free = false;
-                return calc_world_coordinates_of_slot(player_pos, slots, slot);
-            }
-        } break;
-
-        case Slot::Bottom_Left: {
-            if (slots.bottom_left_free) {
-                player.extra_player.slots.bottom_left_free = false;
-                return calc_world_coordinates_of_slot(player_pos, slots, slot);
-            }
-        } break;
-
-        case Slot::Bottom_Right: {
-            if (slots.bottom_right_free) {
-                player.extra_player.slots.bottom_right_free = false;
-                return calc_world_coordinates_of_slot(player_pos, slots, slot);
-            }
-        } break;
+        slots.free_mask &= ~(1u << slot);
+        return slot;
     }
 
-    unreachable("just to make the compiler happy");
-    return {};
+    return SLOT_NONE;
 }
 
-void return_claimed_slot(Game& game, Slot slot) {
-    Entity& player = game_get_player_mutable(game);
+void attack_slots_return(Player_Attack_Slots& slots, Slot slot) {
+    assert(slot < SLOT_COUNT);
+    assert(!(slots.free_mask & (1u << slot)) && "returned a slot that wasnt claimed");
+    slots.free_mask |= 1u << slot;
+}
 
-    switch (slot) {
-        case Slot::None: {
-            unreachable("only a valid position can be returned");
-        } break;
+bool attack_slot_is_inner(Slot slot) {
+    return slot < slot_rings[0].count;
+}
 
-        case Slot::Top_Left: {
-            player.extra_player.slots.top_left_free = true;
-        } break;
+void attack_slots_update(Game& g) {
+    auto& player = game_get_player_mutable(g);
+    auto& slots  = player.extra_player.slots;
+    const Vec2<f32> player_pos = entity_get_pos(player);
 
-        case Slot::Top_Right: {
-            player.extra_player.slots.top_right_free = true;
-        } break;
+    for (u32 idx = 0; idx < SLOT_COUNT; idx++) {
+        slots.world[idx] = player_pos + slots.offsets[idx];
+    }
 
-        case Slot::Bottom_Left: {
-            player.extra_player.slots.bottom_left_free = true;
-        } break;
+    // closest waiting enemy gets moved in first, one free inner slot at a time
+    const u32 inner_mask = slot_ring_mask(0);
+    while (slots.free_mask & inner_mask) {
+        Entity* nearest          = nullptr;
+        f32     nearest_distance = 0.0f;
+        for (auto& e : g.entities) {
+            if (e.type != Entity_Type::Enemy || e.sleeping)        continue;
+            if (e.extra_enemy.slot == SLOT_NONE)                   continue;
+            if (attack_slot_is_inner(e.extra_enemy.slot))          continue;
+            if (e.extra_enemy.state != Enemy_State::Standing
+                && e.extra_enemy.state != Enemy_State::Running)    continue;
+
+            const auto diff     = entity_get_pos(e) - player_pos;
+            const f32  distance = diff.x*diff.x + diff.y*diff.y;
+            if (!nearest || distance < nearest_distance) {
+                nearest          = &e;
+                nearest_distance = distance;
+            }
+        }
+        if (!nearest) break;
 
-        case Slot::Bottom_Right: {
-            player.extra_player.slots.bottom_right_free = true;
-        } break;
+        const Slot inner = attack_slots_nearest_free(slots, inner_mask, entity_get_pos(*nearest));
+        attack_slots_return(slots, nearest->extra_enemy.slot);
+        slots.free_mask &= ~(1u << inner);
+        nearest->extra_enemy.slot       = inner;
+        nearest->extra_enemy.target_pos = slots.world[inner];
     }
 }
 
@@ -380,7 +430,6 @@ void entity_handle_rotating_offsets(Entity& e) {
     if (e.dir != e.dir_prev) {
         if ((e.dir_prev == Direction::Right && e.dir == Direction::Left) ||
             (e.dir_prev == Direction::Left  && e.dir == Direction::Right)) {
-            e.hurtbox_offsets.x = -e.hurtbox_offsets.x - e.hurtbox_offsets.w;
             e.bullet_start_offsets.x = -e.bullet_start_offsets.x;
         }
     }
@@ -393,10 +442,11 @@ Entity* entity_pickup_collectible(const Entity& e, Game& g) {
 
     for (auto& collectible : g.entities) {
         if (collectible.type != Entity_Type::Collectible) continue;
+        if (collectible.sleeping)                         continue;
         if (!collectible.extra_collectible.pickupable) continue;
 
         const auto& collision_box_collectible = entity_get_world_collision_box(collectible);
-        if (SDL_HasRectIntersectionFloat(&collision_box_collectible, &collision_box_e)) {
+        if (entity_boxes_intersect(collision_box_collectible, collision_box_e)) {
             return &collectible;
         }
     }
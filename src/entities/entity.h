@@ -30,7 +30,6 @@ enum struct Entity_Type {
     Player,
     Enemy,
     Barrel,
-    Bullet,
     Collectible,
 };
 
@@ -59,18 +58,49 @@ enum struct Player_State {
 static_assert((u32)Player_State::Standing == 0);
 static_assert((u32)Player_State::Running  == 1);
 
-enum struct Slot { None, Top_Left, Top_Right, Bottom_Left, Bottom_Right };
+// index into Player_Attack_Slots
+using Slot = u32;
+const Slot SLOT_NONE = UINT32_MAX;
+
+// Slots are spread on an ellipse around the player, half of them on each side.
+// Only the first ring is close enough to attack from, the rest is where enemies wait for it.
+struct Slot_Ring {
+    u32 count;
+    f32 radius_x;
+    f32 radius_y;
+};
+
+static constexpr Slot_Ring slot_rings[] = {
+    {4, 16.0f, 5.0f},
+    {6, 30.0f, 7.0f},
+    {8, 44.0f, 9.0f},
+};
+
+static constexpr u32 slot_ring_first(u32 idx_ring) {
+    u32 first = 0;
+    for (u32 idx = 0; idx < idx_ring; idx++) first += slot_rings[idx].count;
+    return first;
+}
+
+const u32 SLOT_COUNT = slot_ring_first(std::size(slot_rings));
+static_assert(SLOT_COUNT <= 32, "the free slots are a u32 bitmask");
+static constexpr bool slot_rings_are_valid() {
+    for (const auto& ring : slot_rings) {
+        if (ring.count == 0 || ring.count % 2 != 0) return false;
+    }
+    return true;
+}
+static_assert(slot_rings_are_valid(), "every ring needs the same amount of slots on both sides");
+
+constexpr u32 slot_ring_mask(u32 idx_ring) {
+    return ((1u << slot_rings[idx_ring].count) - 1) << slot_ring_first(idx_ring);
+}
 
 struct Player_Attack_Slots {
-    Vec2<f32> offset_top_left;
-    Vec2<f32> offset_top_right;
-    Vec2<f32> offset_bottom_left;
-    Vec2<f32> offset_bottom_right;
-
-    bool top_left_free;
-    bool top_right_free;
-    bool bottom_left_free;
-    bool bottom_right_free;
+    u32 free_mask; // bit per slot, set when the slot is free
+    std::array<Vec2<f32>, SLOT_COUNT> offsets;
+    // offsets moved to the player, recomputed for all of the slots at once by attack_slots_update
+    std::array<Vec2<f32>, SLOT_COUNT> world;
 };
 
 // this has to be synced with the player sprite
@@ -222,21 +252,6 @@ struct Collide_Opts {
     bool                         reset_position_on_wall_impact = true;
 };
 
-struct Prop_Thrown_Info {
-    Collectible_Type type;
-    Vec2<f32>        position;
-    Direction        dir;
-    Entity_Type      thrown_by;
-};
-
-struct Prop_Dropped_Info {
-    Collectible_Type type;
-    Vec2<f32>        position;
-    Direction        dir;
-    Entity_Type      dropped_by;
-    bool             instantly_disappear;
-};
-
 struct Entity {
     Handle handle;
     f32 health;
@@ -252,6 +267,9 @@ struct Entity {
     // used to collect all the received damage in a frame
     std::vector<Dmg> damage_queue;
 
+    // set by activity_update, sleeping entities are skipped by the update, collision and combat passes
+    bool sleeping;
+
     f32 sprite_frame_w;
     f32 sprite_frame_h;
     Direction dir;
@@ -260,9 +278,10 @@ struct Entity {
     // this is relative to the player position (which is always considered to
     // be where the center of the bottom border of the drawn sprite is)
     SDL_FRect collision_box_offsets;
-    // same thing goes for hurtbox_offsets
+    // same thing goes for hurtbox_offsets, only used by entities that dont play a clip from the
+    // clip table (thrown props), the others get it from the boxes of their current clip frame
     SDL_FRect hurtbox_offsets;
-    // same thing goes for hitbox_offsets
+    // same thing goes for hitbox_offsets, used when the current clip frame doesnt have its own
     SDL_FRect hitbox_offsets;
     // same thing goes for shadow_offset
     SDL_FRect shadow_offsets;
@@ -285,6 +304,9 @@ struct Entity {
             u64                 last_attack_timestamp; // for resetting combo after some time
             bool                has_knife;
             bool                has_gun;
+            // a melee attack that lands on the first frame of its clip with a hurtbox
+            bool                attack_pending;
+            Hit_Type            attack_hit_type;
         } extra_player;
 
         struct {
@@ -299,6 +321,9 @@ struct Entity {
             bool        has_knife;
             bool        can_spawn_knives;
             bool        has_gun;
+            bool        alt_colors; // the palette swapped variant of its type
+            // a melee attack that lands on the first frame of its clip with a hurtbox
+            bool        attack_pending;
         } extra_enemy;
 
         struct {
@@ -306,16 +331,6 @@ struct Entity {
             std::optional<Collectible_Type> held_collectible;
         } extra_barrel;
 
-        struct {
-            Vec2<f32>    pos_start;
-            Vec2<f32>    pos_curr;
-            Vec2<f32>    pos_end;
-            u64          creation_timestamp;
-            u64          time_of_flight_ms;
-            f32          thickness;
-            f32          length;
-        } extra_bullet;
-
         struct {
             Collectible_Type  type;
             Collectible_State state;
@@ -335,20 +350,38 @@ Vec2<f32> entity_offset_to_bottom_center(const Entity& e);
 Vec2<f32> entity_get_pos(const Entity& e);
 
 SDL_FRect entity_get_world_collision_box(const Entity& e);
-SDL_FRect entity_get_world_hitbox(const Entity& e);
-SDL_FRect entity_get_world_hurtbox(const Entity& e);
+// offsets of the boxes on the current animation frame, facing the entity direction
+SDL_FRect                entity_get_hitbox_offsets(const Entity& e);
+// nullopt on frames that cant deal damage
+std::optional<SDL_FRect> entity_get_hurtbox_offsets(const Entity& e);
+SDL_FRect                entity_get_world_hitbox(const Entity& e);
+std::optional<SDL_FRect> entity_get_world_hurtbox(const Entity& e);
+
+// every collision/combat overlap test should go through this, so that they get counted
+bool entity_boxes_intersect(const SDL_FRect& a, const SDL_FRect& b);
 
 struct Game;
 void entity_draw(SDL_Renderer* r, const Entity& e, const Game* g);
 void entity_draw_knife(SDL_Renderer* r, const Entity& e, Game* g);
 void entity_draw_gun(SDL_Renderer* r, const Entity& e, Game* g);
+// The holder references the sheet of the weapon for as long as it has it. Gaining it loads the sheet
+// right away, so that drawing the weapon never has to.
+void entity_weapon_gained(const Entity& holder, Game& g, Collectible_Type weapon);
+void entity_weapon_lost(const Entity& holder, Game& g, Collectible_Type weapon);
+// sparks from the middle of the hitbox, flying the way the hit was going
+void entity_emit_hit_sparks(const Entity& e, Game& g, Direction dir, u64 count);
 
 Collision_Type entity_movement_handle_collisions_and_pos_change(Entity& e, const Game* g, Collide_Opts opts = {});
 void entity_handle_rotating_offsets(Entity& e);
 
-Slot find_empty_slot(const Player_Attack_Slots& slots);
-Vec2<f32> calc_world_coordinates_of_slot(Vec2<f32> player_world_pos, const Player_Attack_Slots& slots, Slot slot);
-Vec2<f32> claim_slot_position(Game& game, Slot slot);
-void return_claimed_slot(Game& game, Slot slot);
+void attack_slots_init(Player_Attack_Slots& slots, Vec2<f32> player_world_pos);
+// the free slot closest to pos from the innermost ring that has one, SLOT_NONE when all are taken
+Slot attack_slots_claim(Player_Attack_Slots& slots, Vec2<f32> pos);
+void attack_slots_return(Player_Attack_Slots& slots, Slot slot);
+// whether an enemy in this slot is close enough to attack
+bool attack_slot_is_inner(Slot slot);
+// Moves all of the slots to the player and gives the free inner slots
+// to the closest enemies waiting in the outer rings.
+void attack_slots_update(Game& g);
 
 Entity* entity_pickup_collectible(const Entity& e, Game& g);
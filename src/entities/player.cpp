@@ -9,7 +9,7 @@
 #include "../draw.h"
 #include "../utils.h"
 
-Entity player_init(const Sprite* player_sprite, Game& g) {
+Entity player_init(Game& g, Player_Init_Opts opts) {
     const auto sprite_frame_h = 48;
     const auto sprite_frame_w = 48;
     Entity player{};
@@ -25,29 +25,21 @@ Entity player_init(const Sprite* player_sprite, Game& g) {
     player.sprite_frame_w        = sprite_frame_w;
     player.sprite_frame_h        = sprite_frame_h;
     player.collision_box_offsets = {-sprite_frame_w/7.0f, -3.0f,  2.0f*sprite_frame_w/7.0f, 4.0f};
-    player.hurtbox_offsets       = {sprite_frame_w/7.0f,  -16.0f, 10.0f,                    6.0f};
     player.hitbox_offsets        = {-sprite_frame_w/6.5f, -23.0f, 2.0f*sprite_frame_w/6.5f, 15.0f};
     player.shadow_offsets        = {-7.0f,                -1.0f,  14.0f,                    2.0f};
     player.bullet_start_offsets  = {22.0f,                -15.0f};
-    player.anim.sprite           = player_sprite;
+    player.anim.sprite           = opts.sprite;
     player.extra_player.state    = Player_State::Standing;
-    player.extra_player.slots    = {
-        .offset_top_left     = { -sprite_frame_w/3.0f, -4.0f },
-        .offset_top_right    = {  sprite_frame_w/3.0f, -4.0f },
-        .offset_bottom_left  = { -sprite_frame_w/4.0f,  2.0f },
-        .offset_bottom_right = {  sprite_frame_w/4.0f,  2.0f },
-        .top_left_free       = true,
-        .top_right_free      = true,
-        .bottom_left_free    = true,
-        .bottom_right_free   = true,
-    };
+    attack_slots_init(player.extra_player.slots, entity_get_pos(player));
     player.extra_player.has_knife = false;
     player.extra_player.has_gun = true;
+    entity_weapon_gained(player, g, Collectible_Type::Gun);
+    // the player can lose the gun to an enemy, so the enemy gun stays resident for the whole game
+    sheet_acquire(g, Sheet::Enemy_Gun);
+    sheet_require(g, Sheet::Enemy_Gun);
     player.extra_player.bullets = settings.default_bullet_count_on_pick_up;
-    animation_start(player.anim, { .anim_idx = (u32)Player_Anim::Standing, .looping = true});
+    animation_play(player.anim, Clip_Id::Player_Standing);
 
-    g.entities.push_back(player);
-    g.idx_player = g.entities.size() - 1;
     return player;
 }
 
@@ -225,28 +217,6 @@ static bool stopped_moving(const Game& g) {
         && not_pressed(g, Action::Right);
 }
 
-static Anim_Start_Opts player_get_anim_got_hit() {
-    Anim_Start_Opts opts = {};
-    opts.anim_idx = (u32)Player_Anim::Got_Hit;
-    opts.frame_duration_ms = 50;
-    return opts;
-}
-
-static Anim_Start_Opts player_get_anim_knocked_down() {
-    Anim_Start_Opts opts = {};
-    opts.anim_idx = (u32)Player_Anim::Knocked_Down;
-    opts.frame_duration_ms = 125;
-    return opts;
-}
-
-static Anim_Start_Opts player_get_anim_on_the_ground() {
-    Anim_Start_Opts opts = {};
-    opts.anim_idx = (u32)Player_Anim::On_The_Ground;
-    opts.frame_duration_ms = 300;
-    return opts;
-}
-
-
 static void handle_movement(Entity& p, const Game& g) {
     const auto in = g.input;
 
@@ -295,15 +265,15 @@ static void handle_movement(Entity& p, const Game& g) {
     entity_handle_rotating_offsets(p);
 }
 
-static void handle_attack(Entity& p, Game& g, Hit_Type type = Hit_Type::Normal) {
-    SDL_FRect player_hurtbox = entity_get_world_hurtbox(p);
+static void handle_attack(Entity& p, Game& g, const SDL_FRect& player_hurtbox, Hit_Type type) {
     bool attack_success = false;
 
     for (auto& e : g.entities) {
         if (e.type == Entity_Type::Player) continue;
+        if (e.sleeping)                    continue;
 
         SDL_FRect entity_hitbox = entity_get_world_hitbox(e);
-        if (SDL_HasRectIntersectionFloat(&entity_hitbox, &player_hurtbox)) {
+        if (entity_boxes_intersect(entity_hitbox, player_hurtbox)) {
             attack_success = true;
             e.damage_queue.push_back({(f32)p.damage, p.dir, type});
         }
@@ -319,33 +289,44 @@ static void handle_attack(Entity& p, Game& g, Hit_Type type = Hit_Type::Normal)
     }
 }
 
+// Lands the pending attack on the first frame of its clip that has a hurtbox,
+// frames without one dont touch the other entities at all.
+static void handle_pending_attack(Entity& p, Game& g) {
+    if (!p.extra_player.attack_pending) return;
+
+    const auto hurtbox = entity_get_world_hurtbox(p);
+    if (!hurtbox) return;
+
+    p.extra_player.attack_pending = false;
+    handle_attack(p, g, *hurtbox, p.extra_player.attack_hit_type);
+}
+
 const u32 AMOUNT_OF_ATTACKS = 4;
 
 // make this player_attack and then swap animations on combo
 static void player_attack(Entity& p, Game& g) {
-    u32 attack_anim        = (u32)Player_Anim::Punching_Right;
-    Anim_Start_Opts opts   = {};
-    opts.frame_duration_ms = 60;
+    auto clip = Clip_Id::Player_Punch_Right;
+    p.extra_player.attack_pending = false;
 
     if (p.extra_player.has_knife) {
         p.extra_player.state = Player_State::Attacking;
-        opts.anim_idx = (u32)Player_Anim::Punching_Right;
-        animation_start(p.anim, opts);
+        animation_play(p.anim, Clip_Id::Player_Punch_Right);
         collectible_throw(Collectible_Type::Knife, g, p);
         p.extra_player.has_knife = false;
+        entity_weapon_lost(p, g, Collectible_Type::Knife);
         return;
     } else if (p.extra_player.has_gun) {
         p.extra_player.state = Player_State::Attacking;
-        opts.anim_idx = (u32)Player_Anim::Punching_Left;
-        animation_start(p.anim, opts);
+        animation_play(p.anim, Clip_Id::Player_Punch_Left);
 
         if (p.extra_player.bullets == 0) {
             p.extra_player.has_gun = false;
+            entity_weapon_lost(p, g, Collectible_Type::Gun);
             collectible_throw(Collectible_Type::Gun, g, p);
             return;
         }
 
-        bullet_init(g, {
+        spawn_bullet(g, {
             .pos_creator = entity_get_pos(p),
             .offsets     = p.bullet_start_offsets,
             .dir         = p.dir,
@@ -359,115 +340,80 @@ static void player_attack(Entity& p, Game& g) {
     auto type = Hit_Type::Normal;
     switch (should_be) {
         case 0: {
-            attack_anim = (u32)Player_Anim::Punching_Right;
+            clip = Clip_Id::Player_Punch_Right;
         } break;
 
         case 1: {
-            attack_anim = (u32)Player_Anim::Punching_Left;
+            clip = Clip_Id::Player_Punch_Left;
         } break;
 
         case 2: {
-            attack_anim = (u32)Player_Anim::Kicking_Left;
+            clip = Clip_Id::Player_Kick_Left;
         } break;
 
         case 3: {
-            attack_anim = (u32)Player_Anim::Kicking_Right;
-            opts.frame_duration_ms = 45;
+            clip = Clip_Id::Player_Kick_Right;
             type = Hit_Type::Power;
         } break;
     }
 
-    opts.anim_idx = attack_anim;
-    animation_start(p.anim, opts);
+    animation_play(p.anim, clip);
     p.extra_player.state = Player_State::Attacking;
-    handle_attack(p, g, type);
+    p.extra_player.attack_pending  = true;
+    p.extra_player.attack_hit_type = type;
 }
 
 static void player_takeoff(Entity& p) {
     p.extra_player.state = Player_State::Takeoff;
     p.z_vel = settings.jump_velocity;
-    animation_start(
-        p.anim,
-        {
-            .anim_idx = (u32)Player_Anim::Takeoff,
-            .frame_duration_ms = 100
-        }
-    );
+    animation_play(p.anim, Clip_Id::Player_Takeoff);
 }
 
 static void player_jump(Entity& p) {
     p.extra_player.state = Player_State::Jumping;
-    animation_start(p.anim, { .anim_idx = (u32)Player_Anim::Jumping, .looping = true});
+    animation_play(p.anim, Clip_Id::Player_Jumping);
 }
 
 static void player_stand_up(Entity& p) {
     p.extra_player.state = Player_State::Standing_Up;
-    animation_start(
-        p.anim,
-        {
-            .anim_idx = (u32)Player_Anim::Landing,
-            .frame_duration_ms = 200,
-        }
-    );
+    animation_play(p.anim, Clip_Id::Player_Landing);
 }
 
 static void player_lay_on_the_ground(Entity& p) {
     p.extra_player.state = Player_State::On_The_Ground;
-    auto opts = player_get_anim_on_the_ground();
-    animation_start(p.anim, opts);
+    animation_play(p.anim, Clip_Id::Player_On_The_Ground);
 }
 
 static void player_land(Entity& p) {
     p.extra_player.state = Player_State::Landing;
-    animation_start(
-        p.anim,
-        {
-            .anim_idx = (u32)Player_Anim::Landing,
-            .frame_duration_ms = 200
-        }
-    );
+    animation_play(p.anim, Clip_Id::Player_Landing);
 }
 
-static void player_drop_kick(Entity& p, Game& g) {
+static void player_drop_kick(Entity& p) {
     p.extra_player.state = Player_State::Kicking_Drop;
-    animation_start(
-        p.anim,
-        {
-            .anim_idx          = (u32)Player_Anim::Kicking_Drop,
-            .frame_duration_ms = 80,
-            .looping           = false,
-        }
-    );
-    handle_attack(p, g, Hit_Type::Knockdown);
+    animation_play(p.anim, Clip_Id::Player_Kick_Drop);
+    p.extra_player.attack_pending  = true;
+    p.extra_player.attack_hit_type = Hit_Type::Knockdown;
 }
 
 static void player_stand(Entity& p) {
     p.extra_player.state = Player_State::Standing;
-    animation_start(p.anim, { .anim_idx = (u32)Player_Anim::Standing, .looping = true });
+    animation_play(p.anim, Clip_Id::Player_Standing);
 }
 
 static void player_run(Entity& p) {
     p.extra_player.state = Player_State::Running;
-    animation_start(p.anim, { .anim_idx = (u32)Player_Anim::Running, .looping = true});
+    animation_play(p.anim, Clip_Id::Player_Running);
 }
 
 static void player_pick_up_collectible(Entity& p) {
     p.extra_player.state = Player_State::Picking_Up_Collectible;
-    animation_start(p.anim, { .anim_idx = (u32)Player_Anim::Landing });
+    animation_play(p.anim, Clip_Id::Player_Picking_Up);
 }
 
 static void player_die(Entity& p) {
     p.extra_player.state = Player_State::Dying;
-    animation_start(
-        p.anim,
-        {
-            .anim_idx = (u32)Player_Anim::Knocked_Down,
-            .fadeout = {
-                .enabled = true,
-                .perc_per_sec = 0.5f,
-            }
-        }
-    );
+    animation_play(p.anim, Clip_Id::Player_Dying);
 }
 
 static void handle_jump_physics(Entity& p, const Game& g) {
@@ -509,10 +455,12 @@ static void player_pick_up(Entity& p, Game& g) {
         switch (collectible->extra_collectible.type) {
             case Collectible_Type::Knife: {
                 p.extra_player.has_knife = true;
+                entity_weapon_gained(p, g, Collectible_Type::Knife);
             } break;
 
             case Collectible_Type::Gun: {
                 p.extra_player.has_gun = true;
+                entity_weapon_gained(p, g, Collectible_Type::Gun);
                 p.extra_player.bullets = settings.default_bullet_count_on_pick_up;
             } break;
 
@@ -553,10 +501,10 @@ static void player_receive_damage(Entity& p, Game& g) {
 
     if (got_hit) {
         p.extra_player.state = Player_State::Got_Hit;
+        entity_emit_hit_sparks(p, g, p.damage_queue.back().going_to, settings.spark_count_hit);
         switch (most_significant_dmg.type) {
             case Hit_Type::Normal: {
-                auto opts = player_get_anim_got_hit();
-                animation_start(p.anim, opts);
+                animation_play(p.anim, Clip_Id::Player_Got_Hit);
             } break;
 
             case Hit_Type::Knockdown: {
@@ -570,8 +518,7 @@ static void player_receive_damage(Entity& p, Game& g) {
                 }
 
                 p.extra_player.state = Player_State::Knocked_Down;
-                auto opts = player_get_anim_knocked_down();
-                animation_start(p.anim, opts);
+                animation_play(p.anim, Clip_Id::Player_Knocked_Down);
             } break;
 
             case Hit_Type::Power: {
@@ -583,19 +530,20 @@ static void player_receive_damage(Entity& p, Game& g) {
                 }
 
                 p.extra_player.state = Player_State::Knocked_Down;
-                auto opts = player_get_anim_knocked_down();
-                animation_start(p.anim, opts);
+                animation_play(p.anim, Clip_Id::Player_Knocked_Down);
             } break;
         }
 
         if (p.extra_player.has_knife) {
             collectible_drop(Collectible_Type::Knife, g, p, { .instantly_disappear = true });
             p.extra_player.has_knife = false;
+            entity_weapon_lost(p, g, Collectible_Type::Knife);
         }
 
         if (p.extra_player.has_gun) {
             collectible_drop(Collectible_Type::Gun, g, p, { .instantly_disappear = true });
             p.extra_player.has_gun = false;
+            entity_weapon_lost(p, g, Collectible_Type::Gun);
         }
     }
 
@@ -643,7 +591,7 @@ Update_Result player_update(Entity& p, Game& g) {
         } break;
 
         case Player_State::Attacking: {
-            // deal damage if in hitbox
+            handle_pending_attack(p, g);
 
             if (animation_is_finished(p.anim)) {
                 player_stand(p);
@@ -700,7 +648,7 @@ Update_Result player_update(Entity& p, Game& g) {
 
         case Player_State::Jumping: {
             if (just_pressed(g, Action::Attack)) {
-                player_drop_kick(p, g);
+                player_drop_kick(p);
             }
 
             handle_movement(p, g);
@@ -717,6 +665,8 @@ Update_Result player_update(Entity& p, Game& g) {
         } break;
 
         case Player_State::Kicking_Drop: {
+            handle_pending_attack(p, g);
+
             if (p.z == settings.ground_level) {
                 player_land(p);
             }
@@ -733,7 +683,6 @@ Update_Result player_update(Entity& p, Game& g) {
         }
     }
 
-    animation_update(p.anim, g.dt, g.dt_real);
     camera_update(p, g);
 
     return Update_Result::None;
@@ -741,19 +690,12 @@ Update_Result player_update(Entity& p, Game& g) {
 
 static void slots_draw(SDL_Renderer* r, const Entity& p, const Game& g) {
     const auto& slots = p.extra_player.slots;
-    // TODO: maybe consider making the entity position being Vec2 instead of doing that all over the codebase..
-    const Vec2<f32> player_pos = {p.x, p.y};
-    const auto top_left = player_pos + slots.offset_top_left;
-    draw_point(r, {top_left, g, {0, 255, 0, 255}});
-
-    const auto top_right = player_pos + slots.offset_top_right;
-    draw_point(r, {top_right, g, {0, 0, 255, 255}});
-
-    const auto bottom_left = player_pos + slots.offset_bottom_left;
-    draw_point(r, {bottom_left, g, {5, 5, 5, 255}});
-
-    const auto bottom_right = player_pos + slots.offset_bottom_right;
-    draw_point(r, {bottom_right, g, {125, 125, 125, 255}});
+    for (Slot slot = 0; slot < SLOT_COUNT; slot++) {
+        const bool free  = slots.free_mask & (1u << slot);
+        const f32  shade = attack_slot_is_inner(slot) ? 255 : 125;
+        const Color color = free ? Color{0, shade, 0, 255} : Color{shade, 0, 0, 255};
+        draw_point(r, {slots.world[slot], g, color});
+    }
 }
 
 void player_draw(SDL_Renderer* r, const Entity& p, Game& g) {
@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <cmath>
+
+#include "flow_field.h"
+#include "game.h"
+
+static bool flow_field_cell_of(const Flow_Field& f, Vec2<f32> pos, u32& cell) {
+    const f32 col = std::floor((pos.x - f.origin_x) / FLOW_FIELD_CELL_SIZE);
+    const f32 row = std::floor((pos.y - f.origin_y) / FLOW_FIELD_CELL_SIZE);
+    if (col < 0.0f || row < 0.0f || col >= f.cols || row >= f.rows) return false;
+
+    cell = (u32)row * f.cols + (u32)col;
+    return true;
+}
+
+// only the cells whose centers are inside the box
+static void flow_field_block_box(Flow_Field& f, const SDL_FRect& box) {
+    const f32 col_first = std::ceil((box.x - f.origin_x) / FLOW_FIELD_CELL_SIZE - 0.5f);
+    const f32 col_last  = std::floor((box.x + box.w - f.origin_x) / FLOW_FIELD_CELL_SIZE - 0.5f);
+    const f32 row_first = std::ceil((box.y - f.origin_y) / FLOW_FIELD_CELL_SIZE - 0.5f);
+    const f32 row_last  = std::floor((box.y + box.h - f.origin_y) / FLOW_FIELD_CELL_SIZE - 0.5f);
+    if (col_last < 0.0f || row_last < 0.0f || col_first >= f.cols || row_first >= f.rows) return;
+
+    const u32 col_begin = (u32)std::max(0.0f, col_first);
+    const u32 col_end   = (u32)std::min((f32)f.cols - 1.0f, col_last);
+    const u32 row_begin = (u32)std::max(0.0f, row_first);
+    const u32 row_end   = (u32)std::min((f32)f.rows - 1.0f, row_last);
+    for (u32 row = row_begin; row <= row_end; row++) {
+        for (u32 col = col_begin; col <= col_end; col++) f.blocked[row * f.cols + col] = 1;
+    }
+}
+
+// cheap enough to do every frame, the field only gets rebuilt when this changes
+static u64 flow_field_hash_obstacles(const Game& g) {
+    u64 hash = 1469598103934665603ull;
+    for (const auto& e : g.entities) {
+        if (e.type != Entity_Type::Barrel || e.extra_barrel.state != Barrel_State::Idle) continue;
+
+        const u64 x = (u64)(e.x / FLOW_FIELD_CELL_SIZE);
+        const u64 y = (u64)(e.y / FLOW_FIELD_CELL_SIZE);
+        hash = (hash ^ (x << 32 | y)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// returns whether the size of the band changed
+static bool flow_field_layout(Flow_Field& f, const Game& g) {
+    const auto top    = level_info_get_collision_box(g.curr_level_info, Border::Top);
+    const auto bottom = level_info_get_collision_box(g.curr_level_info, Border::Bottom);
+
+    const f32 origin_y = top.y + top.h;
+    const u32 cols     = std::max(1u, (u32)std::ceil(g.bg.width / FLOW_FIELD_CELL_SIZE));
+    const u32 rows     = std::max(1u, (u32)std::ceil((bottom.y - origin_y) / FLOW_FIELD_CELL_SIZE));
+    const bool changed = origin_y != f.origin_y || cols != f.cols || rows != f.rows;
+
+    f.origin_x = 0.0f;
+    f.origin_y = origin_y;
+    f.cols     = cols;
+    f.rows     = rows;
+    return changed;
+}
+
+static void flow_field_block_obstacles(Flow_Field& f, const Game& g) {
+    const auto top    = level_info_get_collision_box(g.curr_level_info, Border::Top);
+    const auto bottom = level_info_get_collision_box(g.curr_level_info, Border::Bottom);
+
+    f.blocked.assign(f.cols * f.rows, 0);
+
+    // the left and right borders follow the camera, so only the static boxes block
+    flow_field_block_box(f, top);
+    flow_field_block_box(f, bottom);
+    for (const auto& box : g.level_bvh.boxes) flow_field_block_box(f, box);
+    for (const auto& e : g.entities) {
+        if (e.type != Entity_Type::Barrel || e.extra_barrel.state != Barrel_State::Idle) continue;
+        flow_field_block_box(f, entity_get_world_collision_box(e));
+    }
+}
+
+// the columns around the camera, the search doesnt leave them
+static void flow_field_window(const Flow_Field& f, const Game& g, u32& col_begin, u32& col_end) {
+    const f32 margin = settings.flow_field_margin;
+    const f32 first  = std::floor((g.camera.x - margin - f.origin_x) / FLOW_FIELD_CELL_SIZE);
+    const f32 last   = std::floor((g.camera.x + g.camera.w + margin - f.origin_x) / FLOW_FIELD_CELL_SIZE);
+    col_begin = (u32)std::clamp(first, 0.0f, (f32)f.cols);
+    col_end   = (u32)std::clamp(last + 1.0f, (f32)col_begin, (f32)f.cols);
+}
+
+static void flow_field_search(Flow_Field& f) {
+    // only the cells the previous search reached have a cost, everything else is still unreachable
+    for (const u32 cell : f.queue) f.cost[cell] = FLOW_FIELD_UNREACHABLE;
+    f.queue.clear();
+    f.recomputations++;
+
+    const u32 cell_count = f.cols * f.rows;
+    if (f.target_cell >= cell_count) return;
+    const u32 target_col = f.target_cell % f.cols;
+    if (target_col < f.col_begin || target_col >= f.col_end) return;
+
+    // the player can always be reached, even when standing right next to a barrel
+    const u8 target_blocked = f.blocked[f.target_cell];
+    f.blocked[f.target_cell] = 0;
+
+    static constexpr int offsets[8][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}, {-1, -1}, {1, -1}, {-1, 1}, {1, 1}};
+
+    // breadth first from the player outwards
+    f.cost[f.target_cell] = 0;
+    f.queue.push_back(f.target_cell);
+    for (usize head = 0; head < f.queue.size(); head++) {
+        const u32 cell = f.queue[head];
+        const int col  = cell % f.cols;
+        const int row  = cell / f.cols;
+
+        for (const auto& offset : offsets) {
+            const int c = col + offset[0];
+            const int r = row + offset[1];
+            if (c < (int)f.col_begin || r < 0 || c >= (int)f.col_end || r >= (int)f.rows) continue;
+
+            // no cutting corners of blocked cells
+            if (offset[0] != 0 && offset[1] != 0) {
+                if (f.blocked[row * f.cols + c] || f.blocked[r * f.cols + col]) continue;
+            }
+
+            const u32 next = r * f.cols + c;
+            if (f.blocked[next] || f.cost[next] != FLOW_FIELD_UNREACHABLE) continue;
+
+            f.cost[next] = f.cost[cell] + 1;
+            f.queue.push_back(next);
+
+            // reached first from here, so this is a shortest way back
+            Vec2<f32> dir = {(f32)-offset[0], (f32)-offset[1]};
+            dir.normalize();
+            f.dir[next] = dir;
+        }
+    }
+
+    f.blocked[f.target_cell] = target_blocked;
+}
+
+void flow_field_update(Flow_Field& f, const Game& g) {
+    const bool layout_changed = flow_field_layout(f, g);
+    if (layout_changed) {
+        const u32 cell_count = f.cols * f.rows;
+        f.cost.assign(cell_count, FLOW_FIELD_UNREACHABLE);
+        f.dir.assign(cell_count, {0.0f, 0.0f});
+        f.queue.clear();
+    }
+
+    const u64 obstacles_hash = flow_field_hash_obstacles(g);
+    const bool obstacles_changed = layout_changed || obstacles_hash != f.obstacles_hash;
+    if (obstacles_changed) {
+        f.obstacles_hash = obstacles_hash;
+        flow_field_block_obstacles(f, g);
+    }
+
+    u32 target_cell;
+    if (!flow_field_cell_of(f, entity_get_pos(game_get_player(g)), target_cell)) target_cell = UINT32_MAX;
+    u32 col_begin, col_end;
+    flow_field_window(f, g, col_begin, col_end);
+
+    if (!obstacles_changed && target_cell == f.target_cell && col_begin == f.col_begin && col_end == f.col_end) return;
+
+    f.target_cell = target_cell;
+    f.col_begin   = col_begin;
+    f.col_end     = col_end;
+    flow_field_search(f);
+}
+
+std::optional<Vec2<f32>> flow_field_sample(const Flow_Field& f, Vec2<f32> pos) {
+    u32 cell;
+    if (!flow_field_cell_of(f, pos, cell)) return std::nullopt;
+    if (f.cost[cell] == 0 || f.cost[cell] == FLOW_FIELD_UNREACHABLE) return std::nullopt;
+    return f.dir[cell];
+}
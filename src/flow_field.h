@@ -0,0 +1,39 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "number_types.h"
+#include "vec2.h"
+
+struct Game;
+
+const f32 FLOW_FIELD_CELL_SIZE  = 4.0f;
+const u16 FLOW_FIELD_UNREACHABLE = UINT16_MAX;
+
+// Directions towards the player for the cells of the walkable band of the level, shared by the whole
+// crowd. The blocked cells are only rasterized again when the obstacles change, the breadth first search
+// is not incremental, it runs again from scratch whenever the player moves into another cell, but only
+// over the columns within settings.flow_field_margin of the camera. Further away enemies dont get a direction.
+struct Flow_Field {
+    f32 origin_x = 0.0f;
+    f32 origin_y = 0.0f;
+    u32 cols     = 0;
+    u32 rows     = 0;
+    u32 target_cell    = UINT32_MAX;
+    u32 col_begin      = 0; // the columns the last search covered
+    u32 col_end        = 0;
+    u64 obstacles_hash = 0;
+    u32 recomputations = 0;
+
+    std::vector<u8>        blocked;
+    std::vector<u16>       cost;  // steps to the target cell, unreachable outside of the window
+    std::vector<Vec2<f32>> dir;   // normalized, towards the neighbour that is the closest to the target
+    std::vector<u32>       queue; // for the breadth first search, afterwards the cells it reached
+};
+
+// The band is between the top and the bottom border of g.curr_level_info, the static geometry
+// of the level and idle barrels block cells.
+void flow_field_update(Flow_Field& f, const Game& g);
+// nullopt outside of the band and the window, on blocked cells and on the target cell itself
+std::optional<Vec2<f32>> flow_field_sample(const Flow_Field& f, Vec2<f32> pos);
@@ -8,7 +8,7 @@ Vec2<f32> game_get_screen_coords(const Game& g, Vec2<f32> world_coords) {
     };
 }
 
-Entity game_get_player(const Game& g) {
+const Entity& game_get_player(const Game& g) {
     return g.entities[g.idx_player];
 }
 
@@ -43,3 +43,8 @@ f32 game_get_border_x(const Game& g, Border border) {
 
     return result;
 }
+
+void game_build_spatial_grid(Game& g) {
+    const SDL_FRect bounds = {0.0f, 0.0f, g.bg.width, (f32)SCREEN_HEIGHT};
+    spatial_grid_build(g.grid, g.entities, bounds);
+}
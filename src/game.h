@@ -7,10 +7,20 @@
 #include <SDL3_ttf/SDL_ttf.h>
 
 #include "sprite.h"
+#include "text.h"
 #include "level_info.h"
+#include "level_bvh.h"
+#include "level_file.h"
+#include "sheet_cache.h"
 #include "entities/entity.h"
 #include "vec2.h"
 #include "debug_menu.h"
+#include "spawn.h"
+#include "entities/bullet.h"
+#include "particles.h"
+#include "spatial_grid.h"
+#include "flow_field.h"
+#include "hot_reload.h"
 
 enum struct Update_Result { None, Remove_Me };
 
@@ -35,8 +45,13 @@ struct Game {
     TTF_Font* font_tiny_mono;
     TTF_Font* font_press_start_2p;
 
+    Font_Atlas atlas_tiny_mono;
+    Font_Atlas atlas_press_start_2p;
+
     Img bg;
+    std::array<Img, LEVEL_MAX_PROP_IMGS> prop_imgs; // of curr_level_info.prop_paths
     Img entity_shadow;
+    Img spark;
 
     Sprite sprite_player = {
         .img                     = {},
@@ -103,6 +118,22 @@ struct Game {
         .max_frames_in_row_count = 10, // THIS HAS TO CORRESPOND TO THE WIDTH OF THE SPRITE -> SPRITE_WIDTH / FRAME_WIDTH
         .frames_in_each_row      = std::span{sprite_enemy_frames},
     };
+    // the sheets above with the colors of assets/art/palettes swapped in when loading
+    Sprite sprite_enemy_goon_alt = {
+        .img                     = {},
+        .max_frames_in_row_count = 10, // THIS HAS TO CORRESPOND TO THE WIDTH OF THE SPRITE -> SPRITE_WIDTH / FRAME_WIDTH
+        .frames_in_each_row      = std::span{sprite_enemy_frames},
+    };
+    Sprite sprite_enemy_punk_alt = {
+        .img                     = {},
+        .max_frames_in_row_count = 10, // THIS HAS TO CORRESPOND TO THE WIDTH OF THE SPRITE -> SPRITE_WIDTH / FRAME_WIDTH
+        .frames_in_each_row      = std::span{sprite_enemy_frames},
+    };
+    Sprite sprite_enemy_thug_alt = {
+        .img                     = {},
+        .max_frames_in_row_count = 10, // THIS HAS TO CORRESPOND TO THE WIDTH OF THE SPRITE -> SPRITE_WIDTH / FRAME_WIDTH
+        .frames_in_each_row      = std::span{sprite_enemy_frames},
+    };
 
     Sprite sprite_enemy_boss = {
         .img                     = {},
@@ -115,24 +146,34 @@ struct Game {
 
     std::vector<Entity>            entities;
     std::vector<u32>               sorted_indices;      // for y-sorting when drawing
-    std::vector<u32>               removal_queue;       // for removing entities at the end of the frame
-    std::vector<Prop_Thrown_Info>  props_thrown_queue;  // gets used when collecting props thrown in the current frame and emptied when creating them
-    std::vector<Prop_Dropped_Info> props_dropped_queue; // gets used when collecting props dropped in the current frame and emptied when creating them
+    Spawn_Buffer                   spawns;              // applied once per frame after updating the entities
+    Bullet_Pool                    bullets;
+    Particle_Pool                  particles;
+    Spatial_Grid                   grid;                // awake entities, rebuilt at the start of every update
+    Flow_Field                     flow;                // towards the player, for every enemy at once
+    Sheet_Cache                    sheets;              // which of the optional sprites are needed and loaded
+    Hot_Reload                     hot_reload;          // dev mode only, swaps in changed images and settings between frames
 
     // TODO: in the future make this a unique type, see handles are better pointers
     u32 idx_player;
 
+    Level      curr_level;
     Level_Info curr_level_info;
+    Level_Bvh  level_bvh; // static boxes of curr_level_info
+    Level_Waves level_waves;
     Camera     camera;
     u64        dt; // scaled by settings.time_scale
     u64        dt_real;
     u64        time_ms = 0;
+    u64        tick    = 0; // amount of updates so far
     u32        last_entity_id = 0;
 };
 
-Vec2<f32> game_get_screen_coords(const Game& g, Vec2<f32> worlds_coords);
-Entity    game_get_player(const Game& g);
-Entity&   game_get_player_mutable(Game& g);
-Handle    game_generate_entity_handle(Game& g);
-Entity*   game_get_mutable_entity_by_handle(Game& g, const Handle& h);
-f32       game_get_border_x(const Game& g, Border border);
+Vec2<f32>     game_get_screen_coords(const Game& g, Vec2<f32> worlds_coords);
+const Entity& game_get_player(const Game& g);
+Entity&       game_get_player_mutable(Game& g);
+Handle        game_generate_entity_handle(Game& g);
+Entity*       game_get_mutable_entity_by_handle(Game& g, const Handle& h);
+f32           game_get_border_x(const Game& g, Border border);
+// over the whole level, at the start of the update and again before bullets fire on changed entities
+void          game_build_spatial_grid(Game& g);
@@ -0,0 +1,299 @@
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include <SDL3_image/SDL_image.h>
+
+#include "hot_reload.h"
+#include "palette.h"
+
+void hot_reload_watch_img(Hot_Reload& h, Img& img, const char* path, const char* palette_path) {
+    // locking a null mutex does nothing in SDL, so this also works before the watcher runs
+    SDL_LockMutex(h.mutex);
+
+    u32 idx = 0;
+    while (idx < h.img_count && h.imgs[idx].img != &img) idx++;
+    if (idx == h.img_count) {
+        if (h.img_count == HOT_RELOAD_MAX_IMGS) {
+            SDL_UnlockMutex(h.mutex);
+            SDL_Log("Too many images to hot reload, %s wont be\n", path);
+            return;
+        }
+        h.img_count++;
+    }
+
+    auto& entry = h.imgs[idx];
+    if (entry.surface) SDL_DestroySurface(entry.surface);
+    entry = {};
+    entry.img = &img;
+    std::snprintf(entry.path,         sizeof(entry.path),         "%s", path);
+    std::snprintf(entry.palette_path, sizeof(entry.palette_path), "%s", palette_path ? palette_path : "");
+
+    SDL_UnlockMutex(h.mutex);
+}
+
+#ifdef __linux__
+
+// the directory of path without the trailing slash, "." for a path without one
+static void hot_reload_dir_of(const char* path, char (&out)[HOT_RELOAD_MAX_PATH]) {
+    const char* slash = std::strrchr(path, '/');
+    if (!slash) {
+        std::snprintf(out, sizeof(out), ".");
+        return;
+    }
+    std::snprintf(out, sizeof(out), "%.*s", (int)(slash - path), path);
+}
+
+// rgba pixels from the loose file, never from the asset pack, that one is only rebuilt by hand
+static SDL_Surface* hot_reload_decode(const char* path, const char* palette_path) {
+    SDL_Surface* loaded = IMG_Load(path);
+    if (!loaded) return nullptr;
+    if (palette_path[0] == '\0') return loaded;
+
+    SDL_Surface* rgba = SDL_ConvertSurface(loaded, SDL_PIXELFORMAT_RGBA32);
+    SDL_DestroySurface(loaded);
+    if (!rgba) return nullptr;
+
+    Palette palette;
+    SDL_Surface* indexed = nullptr;
+    if (palette_load_io(palette, SDL_IOFromFile(palette_path, "rb"), palette_path)) indexed = palette_index_sheet(rgba, palette);
+    SDL_DestroySurface(rgba);
+    return indexed;
+}
+
+static void hot_reload_changed_img(Hot_Reload& h, const char* path) {
+    // copied out, so that the decoding doesnt hold the mutex
+    struct Match {
+        Img* img;
+        char path[HOT_RELOAD_MAX_PATH];
+        char palette_path[HOT_RELOAD_MAX_PATH];
+    };
+    std::array<Match, HOT_RELOAD_MAX_IMGS> matches;
+    u32 match_count = 0;
+
+    SDL_LockMutex(h.mutex);
+    for (u32 idx = 0; idx < h.img_count; idx++) {
+        const auto& entry = h.imgs[idx];
+        if (std::strcmp(entry.path, path) != 0 && std::strcmp(entry.palette_path, path) != 0) continue;
+
+        auto& match = matches[match_count++];
+        match.img = entry.img;
+        std::memcpy(match.path,         entry.path,         sizeof(match.path));
+        std::memcpy(match.palette_path, entry.palette_path, sizeof(match.palette_path));
+    }
+    SDL_UnlockMutex(h.mutex);
+
+    for (u32 idx_match = 0; idx_match < match_count; idx_match++) {
+        const auto& match = matches[idx_match];
+        SDL_Surface* surface = hot_reload_decode(match.path, match.palette_path);
+        if (!surface) {
+            SDL_Log("Failed to hot reload %s! SDL err: %s\n", match.path, SDL_GetError());
+            continue;
+        }
+
+        SDL_LockMutex(h.mutex);
+        bool taken = false;
+        for (u32 idx = 0; idx < h.img_count; idx++) {
+            auto& entry = h.imgs[idx];
+            // the img could have been registered with another path in the meantime
+            if (entry.img != match.img || std::strcmp(entry.path, match.path) != 0) continue;
+
+            // a newer save replaces one that wasnt applied yet
+            if (entry.surface) SDL_DestroySurface(entry.surface);
+            entry.surface = surface;
+            taken = true;
+        }
+        SDL_UnlockMutex(h.mutex);
+        if (!taken) SDL_DestroySurface(surface);
+    }
+}
+
+static void hot_reload_changed(Hot_Reload& h, const char* path) {
+    if (std::strcmp(path, h.settings_path) == 0) {
+        Settings_Overrides parsed;
+        if (!settings_load(parsed, path)) return;
+
+        SDL_LockMutex(h.mutex);
+        h.settings         = parsed;
+        h.settings_changed = true;
+        SDL_UnlockMutex(h.mutex);
+        return;
+    }
+
+    hot_reload_changed_img(h, path);
+}
+
+static int hot_reload_watcher(void* data) {
+    auto& h = *(Hot_Reload*)data;
+
+    // big enough for a few events with the longest names
+    alignas(inotify_event) char buffer[4096];
+    while (!SDL_GetAtomicInt(&h.quit)) {
+        pollfd fd = {h.fd, POLLIN, 0};
+        // wakes up every now and then to check quit
+        if (poll(&fd, 1, 100) <= 0) continue;
+
+        const ssize_t len = read(h.fd, buffer, sizeof(buffer));
+        if (len <= 0) continue;
+
+        for (ssize_t offset = 0; offset < len;) {
+            const auto& event = *(const inotify_event*)(buffer + offset);
+            offset += sizeof(inotify_event) + event.len;
+            if (event.len == 0) continue;
+
+            u32 idx_watch = 0;
+            while (idx_watch < h.watch_count && h.watches[idx_watch] != event.wd) idx_watch++;
+            if (idx_watch == h.watch_count) continue;
+
+            // the paths of the images are relative to the working directory, without a leading ./
+            char path[HOT_RELOAD_MAX_PATH];
+            const char* dir = h.watch_dirs[idx_watch];
+            if (std::strcmp(dir, ".") == 0) std::snprintf(path, sizeof(path), "%s", event.name);
+            else                            std::snprintf(path, sizeof(path), "%s/%s", dir, event.name);
+            hot_reload_changed(h, path);
+        }
+    }
+    return 0;
+}
+
+static void hot_reload_add_watch(Hot_Reload& h, const char* dir) {
+    for (u32 idx = 0; idx < h.watch_count; idx++) {
+        if (std::strcmp(h.watch_dirs[idx], dir) == 0) return;
+    }
+    if (h.watch_count == HOT_RELOAD_MAX_WATCHES) {
+        SDL_Log("Too many directories to watch, %s isnt\n", dir);
+        return;
+    }
+
+    // editors either write the file in place or move a new one over it
+    const int wd = inotify_add_watch(h.fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (wd < 0) {
+        SDL_Log("Could not watch %s for hot reloading!\n", dir);
+        return;
+    }
+    h.watches[h.watch_count] = wd;
+    std::snprintf(h.watch_dirs[h.watch_count], sizeof(h.watch_dirs[h.watch_count]), "%s", dir);
+    h.watch_count++;
+}
+
+bool hot_reload_start(Hot_Reload& h, const char* settings_path) {
+    // the same relative form as the paths the watcher builds from its events
+    if (std::strncmp(settings_path, "./", 2) == 0) settings_path += 2;
+    std::snprintf(h.settings_path, sizeof(h.settings_path), "%s", settings_path);
+
+    h.fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (h.fd < 0) {
+        SDL_Log("Could not initialize inotify, hot reloading is off!\n");
+        return false;
+    }
+
+    char dir[HOT_RELOAD_MAX_PATH];
+    hot_reload_dir_of(h.settings_path, dir);
+    hot_reload_add_watch(h, dir);
+    for (u32 idx = 0; idx < h.img_count; idx++) {
+        const auto& entry = h.imgs[idx];
+        hot_reload_dir_of(entry.path, dir);
+        hot_reload_add_watch(h, dir);
+        if (entry.palette_path[0] == '\0') continue;
+        hot_reload_dir_of(entry.palette_path, dir);
+        hot_reload_add_watch(h, dir);
+    }
+
+    h.mutex = SDL_CreateMutex();
+    if (!h.mutex) {
+        SDL_Log("Could not create the hot reload mutex! SDL err: %s\n", SDL_GetError());
+        hot_reload_stop(h);
+        return false;
+    }
+    SDL_SetAtomicInt(&h.quit, 0);
+    h.thread = SDL_CreateThread(hot_reload_watcher, "hot_reload", &h);
+    if (!h.thread) {
+        SDL_Log("Could not create the hot reload watcher! SDL err: %s\n", SDL_GetError());
+        hot_reload_stop(h);
+        return false;
+    }
+    return true;
+}
+
+#else
+
+bool hot_reload_start(Hot_Reload& h, const char* settings_path) {
+    (void)h;
+    (void)settings_path;
+    SDL_Log("Hot reloading is only implemented on Linux\n");
+    return false;
+}
+
+#endif
+
+void hot_reload_apply(Hot_Reload& h, SDL_Renderer* r) {
+    if (!h.thread) return;
+
+    struct Upload {
+        Img*         img;
+        SDL_Surface* surface;
+        const char*  path; // only logged, registering happens on this thread too
+    };
+    std::array<Upload, HOT_RELOAD_MAX_IMGS> uploads;
+    u32 upload_count = 0;
+    Settings_Overrides overrides;
+    bool settings_changed = false;
+
+    SDL_LockMutex(h.mutex);
+    for (u32 idx = 0; idx < h.img_count; idx++) {
+        auto& entry = h.imgs[idx];
+        if (!entry.surface) continue;
+        uploads[upload_count++] = {entry.img, entry.surface, entry.path};
+        entry.surface = nullptr;
+    }
+    if (h.settings_changed) {
+        overrides          = h.settings;
+        h.settings_changed = false;
+        settings_changed   = true;
+    }
+    SDL_UnlockMutex(h.mutex);
+
+    for (u32 idx = 0; idx < upload_count; idx++) {
+        const auto& upload = uploads[idx];
+        // an evicted sheet, it gets loaded from the new file the next time it is needed
+        if (!upload.img->img) {
+            SDL_DestroySurface(upload.surface);
+            continue;
+        }
+
+        SDL_DestroyTexture(upload.img->img);
+        if (img_load_from_surface(*upload.img, r, upload.surface)) SDL_Log("Reloaded %s\n", upload.path);
+        else                                                      SDL_Log("Failed to reload %s!\n", upload.path);
+        SDL_DestroySurface(upload.surface);
+    }
+
+    if (settings_changed) {
+        settings_apply(settings_pending, overrides);
+        SDL_Log("Reloaded %s\n", h.settings_path);
+    }
+}
+
+void hot_reload_stop(Hot_Reload& h) {
+    SDL_SetAtomicInt(&h.quit, 1);
+    if (h.thread) SDL_WaitThread(h.thread, nullptr);
+    h.thread = nullptr;
+
+#ifdef __linux__
+    if (h.fd > 0) close(h.fd);
+    h.fd = 0;
+    h.watch_count = 0;
+#endif
+
+    for (u32 idx = 0; idx < h.img_count; idx++) {
+        auto& entry = h.imgs[idx];
+        if (entry.surface) SDL_DestroySurface(entry.surface);
+        entry.surface = nullptr;
+    }
+    if (h.mutex) SDL_DestroyMutex(h.mutex);
+    h.mutex = nullptr;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <SDL3/SDL.h>
+
+#include "number_types.h"
+#include "settings.h"
+#include "sprite.h"
+
+const u32 HOT_RELOAD_MAX_IMGS    = 32;
+const u32 HOT_RELOAD_MAX_WATCHES = 16;
+const u32 HOT_RELOAD_MAX_PATH    = 128;
+
+struct Hot_Reload_Img {
+    char         path[HOT_RELOAD_MAX_PATH];
+    char         palette_path[HOT_RELOAD_MAX_PATH]; // empty without a palette swap
+    Img*         img;
+    // decoded by the watcher, uploaded by hot_reload_apply
+    SDL_Surface* surface;
+};
+
+// For development, watches the directories of the images and the settings file.
+// A changed file is decoded (or parsed) on the watcher thread, the main thread only swaps in the results
+// between frames, the textures are replaced in place so that every pointer to a Sprite or an Img stays valid.
+// Only implemented with inotify, on other platforms nothing gets reloaded.
+//
+// Everything below is guarded by mutex once the watcher runs, the watcher never allocates
+// through new since the allocation counters arent thread safe.
+struct Hot_Reload {
+    std::array<Hot_Reload_Img, HOT_RELOAD_MAX_IMGS> imgs;
+    u32 img_count;
+
+    char               settings_path[HOT_RELOAD_MAX_PATH];
+    Settings_Overrides settings;
+    bool               settings_changed;
+
+    // only touched by hot_reload_start and the watcher
+    int fd;
+    std::array<int,                        HOT_RELOAD_MAX_WATCHES> watches;
+    std::array<char[HOT_RELOAD_MAX_PATH], HOT_RELOAD_MAX_WATCHES> watch_dirs;
+    u32 watch_count;
+
+    SDL_Mutex*    mutex;
+    SDL_Thread*   thread;
+    SDL_AtomicInt quit;
+};
+
+// Registering the same img again replaces its paths, like when the level changes its bg.
+// The directories are only watched if they already had an image at hot_reload_start.
+void hot_reload_watch_img(Hot_Reload& h, Img& img, const char* path, const char* palette_path = nullptr);
+
+// returns false if the watcher cant be started, the game runs fine without it
+bool hot_reload_start(Hot_Reload& h, const char* settings_path);
+// Has to be called on the render thread, between frames. The settings go into settings_pending,
+// they take effect with the next settings_publish.
+void hot_reload_apply(Hot_Reload& h, SDL_Renderer* r);
+void hot_reload_stop(Hot_Reload& h);
@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <cassert>
+
+#include "level_bvh.h"
+#include "perf.h"
+
+// deeper than this would need way more boxes than a level has
+static const u32 LEVEL_BVH_MAX_DEPTH = 32;
+
+static SDL_FRect level_bvh_union(SDL_FRect a, SDL_FRect b) {
+    const f32 x1 = std::min(a.x, b.x);
+    const f32 y1 = std::min(a.y, b.y);
+    const f32 x2 = std::max(a.x + a.w, b.x + b.w);
+    const f32 y2 = std::max(a.y + a.h, b.y + b.h);
+    return {x1, y1, x2 - x1, y2 - y1};
+}
+
+static bool level_bvh_overlap(const SDL_FRect& a, const SDL_FRect& b) {
+    perf.frame.collision_tests++;
+    return SDL_HasRectIntersectionFloat(&a, &b);
+}
+
+// builds the node at idx_node over boxes[first] .. boxes[first + count]
+static void level_bvh_build_node(Level_Bvh& bvh, u32 idx_node, u32 first, u32 count, u32 depth) {
+    SDL_FRect bounds = bvh.boxes[first];
+    for (u32 idx = first + 1; idx < first + count; idx++) bounds = level_bvh_union(bounds, bvh.boxes[idx]);
+    bvh.nodes[idx_node].bounds = bounds;
+
+    if (count <= LEVEL_BVH_LEAF_SIZE || depth == LEVEL_BVH_MAX_DEPTH) {
+        bvh.nodes[idx_node].first = first;
+        bvh.nodes[idx_node].count = count;
+        return;
+    }
+
+    // split the boxes in half by their centers along the longer side, levels are long and flat so mostly along x
+    const bool along_x = bounds.w >= bounds.h;
+    auto center = [along_x](const SDL_FRect& box) {
+        return along_x ? box.x + box.w / 2 : box.y + box.h / 2;
+    };
+    const u32 half = count / 2;
+    std::nth_element(bvh.boxes.begin() + first, bvh.boxes.begin() + first + half, bvh.boxes.begin() + first + count,
+        [&](const SDL_FRect& a, const SDL_FRect& b) { return center(a) < center(b); });
+
+    const u32 idx_left = (u32)bvh.nodes.size();
+    bvh.nodes.push_back({});
+    bvh.nodes.push_back({});
+    bvh.nodes[idx_node].first = idx_left;
+    bvh.nodes[idx_node].count = 0;
+
+    level_bvh_build_node(bvh, idx_left,     first,        half,         depth + 1);
+    level_bvh_build_node(bvh, idx_left + 1, first + half, count - half, depth + 1);
+}
+
+void level_bvh_build(Level_Bvh& bvh, std::span<const SDL_FRect> boxes) {
+    bvh.boxes.assign(boxes.begin(), boxes.end());
+    bvh.nodes.clear();
+    if (bvh.boxes.empty()) return;
+
+    // a binary tree with leaves of at least one box never has more nodes than this
+    bvh.nodes.reserve(2 * bvh.boxes.size());
+    bvh.nodes.push_back({});
+    level_bvh_build_node(bvh, 0, 0, (u32)bvh.boxes.size(), 0);
+}
+
+bool level_bvh_intersects(const Level_Bvh& bvh, SDL_FRect area) {
+    if (bvh.nodes.empty()) return false;
+
+    u32 stack[LEVEL_BVH_MAX_DEPTH + 1];
+    u32 stack_size = 0;
+    stack[stack_size++] = 0;
+
+    while (stack_size > 0) {
+        const auto& node = bvh.nodes[stack[--stack_size]];
+        if (!level_bvh_overlap(node.bounds, area)) continue;
+
+        if (node.count == 0) {
+            assert(stack_size + 2 <= LEVEL_BVH_MAX_DEPTH + 1);
+            stack[stack_size++] = node.first;
+            stack[stack_size++] = node.first + 1;
+            continue;
+        }
+
+        for (u32 idx = node.first; idx < node.first + node.count; idx++) {
+            if (level_bvh_overlap(bvh.boxes[idx], area)) return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+#include "number_types.h"
+
+// at most this many boxes end up in a leaf
+const u32 LEVEL_BVH_LEAF_SIZE = 2;
+
+// bounds of the node, a leaf holds boxes[first] .. boxes[first + count],
+// an inner node has count 0 and its children at nodes[first] and nodes[first + 1]
+struct Level_Bvh_Node {
+    SDL_FRect bounds;
+    u32       first;
+    u32       count;
+};
+
+// A bounding volume hierarchy over the static colliders of a level, built once when the level is loaded.
+// Nodes are stored depth first, the root is nodes[0], the boxes are reordered so that every leaf is a range.
+struct Level_Bvh {
+    std::vector<Level_Bvh_Node> nodes;
+    std::vector<SDL_FRect>      boxes;
+};
+
+void level_bvh_build(Level_Bvh& bvh, std::span<const SDL_FRect> boxes);
+// whether area overlaps any of the boxes, only walks the nodes whose bounds it overlaps
+bool level_bvh_intersects(const Level_Bvh& bvh, SDL_FRect area);
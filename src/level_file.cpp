@@ -0,0 +1,303 @@
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <SDL3/SDL.h>
+
+#include "level_file.h"
+#include "game.h"
+#include "asset_pack.h"
+
+// a line never has more words than an enemy with every flag
+static const u32 LEVEL_FILE_MAX_WORDS = 11;
+
+struct Level_File_Line {
+    const char* words[LEVEL_FILE_MAX_WORDS];
+    u32         count;
+};
+
+// splits the line in place, the words point into it
+static bool level_file_split(char* line, Level_File_Line& out) {
+    out.count = 0;
+    char* comment = std::strchr(line, '#');
+    if (comment) *comment = '\0';
+
+    char* curr = line;
+    while (*curr) {
+        while (*curr == ' ' || *curr == '\t' || *curr == '\r') *curr++ = '\0';
+        if (!*curr) break;
+        if (out.count == LEVEL_FILE_MAX_WORDS) return false;
+        out.words[out.count++] = curr;
+        while (*curr && *curr != ' ' && *curr != '\t' && *curr != '\r') curr++;
+    }
+    return true;
+}
+
+static bool level_file_parse_f32(const char* str, f32& out) {
+    char* end = nullptr;
+    out = std::strtof(str, &end);
+    return end != str && *end == '\0';
+}
+
+static bool level_file_parse_box(const Level_File_Line& line, u32 idx_first, SDL_FRect& out) {
+    if (line.count != idx_first + 4) return false;
+    return level_file_parse_f32(line.words[idx_first],     out.x)
+        && level_file_parse_f32(line.words[idx_first + 1], out.y)
+        && level_file_parse_f32(line.words[idx_first + 2], out.w)
+        && level_file_parse_f32(line.words[idx_first + 3], out.h);
+}
+
+static bool level_file_parse_border(const char* str, Border& out) {
+    if      (std::strcmp(str, "top")    == 0) out = Border::Top;
+    else if (std::strcmp(str, "bottom") == 0) out = Border::Bottom;
+    else if (std::strcmp(str, "left")   == 0) out = Border::Left;
+    else if (std::strcmp(str, "right")  == 0) out = Border::Right;
+    else return false;
+    return true;
+}
+
+static bool level_file_parse_enemy_type(const char* str, Enemy_Type& out) {
+    if      (std::strcmp(str, "goon") == 0) out = Enemy_Type::Goon;
+    else if (std::strcmp(str, "punk") == 0) out = Enemy_Type::Punk;
+    else if (std::strcmp(str, "thug") == 0) out = Enemy_Type::Thug;
+    else if (std::strcmp(str, "boss") == 0) out = Enemy_Type::Boss;
+    else return false;
+    return true;
+}
+
+static bool level_file_parse_held(const char* str, std::optional<Collectible_Type>& out) {
+    if      (std::strcmp(str, "none")  == 0) out = std::nullopt;
+    else if (std::strcmp(str, "knife") == 0) out = Collectible_Type::Knife;
+    else if (std::strcmp(str, "gun")   == 0) out = Collectible_Type::Gun;
+    else if (std::strcmp(str, "food")  == 0) out = Collectible_Type::Food;
+    else return false;
+    return true;
+}
+
+static bool level_file_parse_enemy(const Level_File_Line& line, Enemy_Init_Opts& out) {
+    if (line.count < 6) return false;
+
+    out = {};
+    bool ok = level_file_parse_enemy_type(line.words[1], out.type)
+        && level_file_parse_f32(line.words[2], out.x)
+        && level_file_parse_f32(line.words[3], out.y)
+        && level_file_parse_f32(line.words[4], out.health)
+        && level_file_parse_f32(line.words[5], out.damage);
+    if (!ok) return false;
+
+    for (u32 idx = 6; idx < line.count; idx++) {
+        const char* flag = line.words[idx];
+        if      (std::strcmp(flag, "knife")         == 0) out.has_knife        = true;
+        else if (std::strcmp(flag, "gun")           == 0) out.has_gun          = true;
+        else if (std::strcmp(flag, "spawns-knives") == 0) out.can_spawn_knives = true;
+        else if (std::strcmp(flag, "alt")           == 0) out.alt_colors       = true;
+        else return false;
+    }
+    return true;
+}
+
+static bool level_file_parse_barrel(const Level_File_Line& line, Barrel_Init_Opts& out) {
+    if (line.count != 5) return false;
+
+    out = {};
+    return level_file_parse_f32(line.words[1], out.x)
+        && level_file_parse_f32(line.words[2], out.y)
+        && level_file_parse_f32(line.words[3], out.health)
+        && level_file_parse_held(line.words[4], out.held_collectible);
+}
+
+// a spawn before the first wave line goes into a wave at the very start of the level
+static void level_file_add_spawn(Level_Waves& waves, const Level_Spawn& spawn) {
+    if (waves.waves.empty()) waves.waves.push_back({0.0f, (u32)waves.spawns.size(), 0});
+    waves.spawns.push_back(spawn);
+    waves.waves.back().spawn_count++;
+}
+
+static bool level_file_parse_line(const Level_File_Line& line, Level_Info& info, Level_Waves& waves) {
+    const char* directive = line.words[0];
+
+    if (std::strcmp(directive, "bg") == 0) {
+        if (line.count != 2) return false;
+        info.bg_path = line.words[1];
+    } else if (std::strcmp(directive, "border") == 0) {
+        Border    border;
+        SDL_FRect box;
+        if (line.count < 2 || !level_file_parse_border(line.words[1], border)) return false;
+        if (!level_file_parse_box(line, 2, box)) return false;
+        level_info_update_collision_box(info, border, box);
+    } else if (std::strcmp(directive, "box") == 0) {
+        SDL_FRect box;
+        if (!level_file_parse_box(line, 1, box)) return false;
+        info.static_boxes.push_back(box);
+    } else if (std::strcmp(directive, "prop") == 0) {
+        Level_Prop prop;
+        if (line.count != 4 && line.count != 8) return false;
+        if (!level_file_parse_f32(line.words[2], prop.x) || !level_file_parse_f32(line.words[3], prop.y)) return false;
+        if (line.count == 8) {
+            SDL_FRect box;
+            if (!level_file_parse_box(line, 4, box)) return false;
+            info.static_boxes.push_back({prop.x + box.x, prop.y + box.y, box.w, box.h});
+        }
+
+        prop.idx_img = 0;
+        while (prop.idx_img < info.prop_paths.size() && info.prop_paths[prop.idx_img] != line.words[1]) prop.idx_img++;
+        if (prop.idx_img == info.prop_paths.size()) {
+            if (info.prop_paths.size() == LEVEL_MAX_PROP_IMGS) return false;
+            info.prop_paths.push_back(line.words[1]);
+        }
+        info.props.push_back(prop);
+    } else if (std::strcmp(directive, "wave") == 0) {
+        f32 camera_x;
+        if (line.count != 2 || !level_file_parse_f32(line.words[1], camera_x)) return false;
+        // in order, so that the streaming only ever has to look at the next one
+        if (!waves.waves.empty() && camera_x < waves.waves.back().camera_x) return false;
+        waves.waves.push_back({camera_x, (u32)waves.spawns.size(), 0});
+    } else if (std::strcmp(directive, "enemy") == 0) {
+        Level_Spawn spawn = {};
+        spawn.type = Level_Spawn_Type::Enemy;
+        if (!level_file_parse_enemy(line, spawn.enemy)) return false;
+        level_file_add_spawn(waves, spawn);
+    } else if (std::strcmp(directive, "barrel") == 0) {
+        Level_Spawn spawn = {};
+        spawn.type = Level_Spawn_Type::Barrel;
+        if (!level_file_parse_barrel(line, spawn.barrel)) return false;
+        level_file_add_spawn(waves, spawn);
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+bool level_file_load(Level_Info& info, Level_Waves& waves, const char* path) {
+    size_t size = 0;
+    SDL_IOStream* io = asset_open_io(path);
+    char* data = io ? (char*)SDL_LoadFile_IO(io, &size, true) : nullptr;
+    if (!data) {
+        SDL_Log("Failed to read level file %s! SDL err: %s\n", path, SDL_GetError());
+        return false;
+    }
+    // the lines get cut up in place
+    std::string text(data, size);
+    SDL_free(data);
+
+    info  = {};
+    waves = {};
+
+    u32   line_number = 0;
+    char* curr        = text.data();
+    while (curr) {
+        line_number++;
+        char* next = std::strchr(curr, '\n');
+        if (next) *next++ = '\0';
+
+        Level_File_Line line;
+        bool ok = level_file_split(curr, line);
+        if (ok && line.count > 0) ok = level_file_parse_line(line, info, waves);
+        if (!ok) {
+            SDL_Log("Malformed line %u in level file %s\n", line_number, path);
+            return false;
+        }
+
+        curr = next;
+    }
+
+    if (info.bg_path.empty()) {
+        SDL_Log("Level file %s has no bg\n", path);
+        return false;
+    }
+
+    return true;
+}
+
+static bool level_spawn_has_knife(const Level_Spawn& spawn) {
+    switch (spawn.type) {
+        case Level_Spawn_Type::Enemy:  return spawn.enemy.has_knife || spawn.enemy.can_spawn_knives;
+        case Level_Spawn_Type::Barrel: return spawn.barrel.held_collectible == Collectible_Type::Knife;
+    }
+    return false;
+}
+
+// every enemy still to come holds its sheet, knives anywhere in the level hold the knife sheets
+static void level_waves_acquire_sheets(Game& g) {
+    auto& w = g.level_waves;
+    for (const auto& spawn : w.spawns) {
+        if (spawn.type == Level_Spawn_Type::Enemy) sheet_acquire(g, sheet_of_enemy(spawn.enemy.type, spawn.enemy.alt_colors));
+        if (level_spawn_has_knife(spawn)) w.has_knives = true;
+    }
+    if (w.has_knives) {
+        sheet_acquire(g, Sheet::Enemy_Knife);
+        sheet_acquire(g, Sheet::Player_Knife);
+    }
+}
+
+void level_waves_clear(Game& g) {
+    auto& w = g.level_waves;
+    for (u32 idx_wave = w.idx_next_wave; idx_wave < w.waves.size(); idx_wave++) {
+        const auto& wave = w.waves[idx_wave];
+        for (u32 idx = wave.first_spawn; idx < wave.first_spawn + wave.spawn_count; idx++) {
+            const auto& spawn = w.spawns[idx];
+            if (spawn.type == Level_Spawn_Type::Enemy) sheet_release(g, sheet_of_enemy(spawn.enemy.type, spawn.enemy.alt_colors));
+        }
+    }
+    if (w.has_knives) {
+        sheet_release(g, Sheet::Enemy_Knife);
+        sheet_release(g, Sheet::Player_Knife);
+    }
+    w = {};
+}
+
+bool level_load(Game& g, Level level) {
+    level_waves_clear(g);
+
+    bool ok = level_file_load(g.curr_level_info, g.level_waves, level_file_paths[(usize)level]);
+    if (!ok) return false;
+
+    g.curr_level = level;
+    level_bvh_build(g.level_bvh, level_info_get_static_boxes(g.curr_level_info));
+    level_waves_acquire_sheets(g);
+    g.camera = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+    g.flow   = {};
+    return true;
+}
+
+static void level_wave_prefetch(Game& g, const Level_Wave& wave) {
+    const auto& w = g.level_waves;
+    for (u32 idx = wave.first_spawn; idx < wave.first_spawn + wave.spawn_count; idx++) {
+        const auto& spawn = w.spawns[idx];
+        if (spawn.type == Level_Spawn_Type::Enemy) sheet_require(g, sheet_of_enemy(spawn.enemy.type, spawn.enemy.alt_colors));
+        if (level_spawn_has_knife(spawn)) {
+            sheet_require(g, Sheet::Enemy_Knife);
+            sheet_require(g, Sheet::Player_Knife);
+        }
+    }
+}
+
+void level_waves_update(Game& g) {
+    auto& w = g.level_waves;
+
+    // ahead of the trigger, so that the loading doesnt hitch the frame in which the wave appears
+    while (w.idx_prefetch_wave < w.waves.size() && w.waves[w.idx_prefetch_wave].camera_x <= g.camera.x + settings.sheet_prefetch_distance) {
+        level_wave_prefetch(g, w.waves[w.idx_prefetch_wave++]);
+    }
+
+    while (w.idx_next_wave < w.waves.size() && w.waves[w.idx_next_wave].camera_x <= g.camera.x) {
+        const auto& wave = w.waves[w.idx_next_wave++];
+        for (u32 idx = wave.first_spawn; idx < wave.first_spawn + wave.spawn_count; idx++) {
+            const auto& spawn = w.spawns[idx];
+            switch (spawn.type) {
+                case Level_Spawn_Type::Enemy: {
+                    // the enemy takes its own reference once it exists
+                    spawn_enemy(g, spawn.enemy);
+                    sheet_release(g, sheet_of_enemy(spawn.enemy.type, spawn.enemy.alt_colors));
+                } break;
+
+                case Level_Spawn_Type::Barrel: {
+                    auto opts   = spawn.barrel;
+                    opts.sprite = &g.sprite_barrel;
+                    spawn_barrel(g, opts);
+                } break;
+            }
+        }
+    }
+}
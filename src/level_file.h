@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+
+#include "number_types.h"
+#include "level_info.h"
+#include "spawn.h"
+
+struct Game;
+
+// A level file is plain text, one directive per line, # starts a comment:
+//
+//   bg <path>
+//   border <top|bottom|left|right> <x> <y> <w> <h>
+//   box <x> <y> <w> <h>
+//   prop <path> <x> <y> [<x> <y> <w> <h>]
+//   wave <camera x>
+//   barrel <x> <y> <health> <none|knife|gun|food>
+//   enemy <goon|punk|thug|boss> <x> <y> <health> <damage> [knife] [gun] [spawns-knives] [alt]
+//
+// alt draws the enemy with the palette swapped colors of its type, the boss has none. The optional box of a
+// prop is a static collider relative to its top left, so that the two cant drift apart.
+// Barrels and enemies belong to the last wave above them, the waves have to be in order of their camera x.
+
+enum struct Level_Spawn_Type {
+    Enemy,
+    Barrel,
+};
+
+struct Level_Spawn {
+    Level_Spawn_Type type;
+    Enemy_Init_Opts  enemy;
+    Barrel_Init_Opts barrel; // without the sprite, that is only known once the game is running
+};
+
+struct Level_Wave {
+    f32 camera_x;    // spawned once g.camera.x got this far
+    u32 first_spawn; // into Level_Waves::spawns
+    u32 spawn_count;
+};
+
+// Only the descriptions of the spawns are kept around, the entities are created wave by wave.
+// Every spawn that hasnt happened yet holds a reference to the sheet of its enemy in g.sheets.
+struct Level_Waves {
+    std::vector<Level_Spawn> spawns;
+    std::vector<Level_Wave>  waves;
+    u32                      idx_next_wave     = 0;
+    u32                      idx_prefetch_wave = 0; // the first one whose sheets arent loaded yet
+    bool                     has_knives        = false; // holds the knife sheets for the whole level
+};
+
+// returns false if the file cant be read or has a malformed line
+bool level_file_load(Level_Info& info, Level_Waves& waves, const char* path);
+
+// Replaces the current level info, static geometry and waves with the ones from the file of the level.
+// The sheets of the previous level that nothing else holds can be evicted afterwards.
+//
+// returns false on error
+bool level_load(Game& g, Level level);
+
+// Drops the waves that havent spawned yet together with their sheet references.
+void level_waves_clear(Game& g);
+
+// Loads the sheets of the waves that the camera is getting close to, and records the spawns of
+// every wave that the camera has reached since the last call, they get created by spawn_buffer_apply.
+void level_waves_update(Game& g);
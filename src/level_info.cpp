@@ -12,6 +12,6 @@ void level_info_update_collision_box(Level_Info& info, Border border, SDL_FRect
     info.collision_boxes[(usize)border] = box;
 }
 
-Level_Info level_data_get_level(Level level) {
-    return level_data[(usize)level];
+std::span<const SDL_FRect> level_info_get_static_boxes(const Level_Info& li) {
+    return std::span(li.static_boxes);
 }
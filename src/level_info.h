@@ -5,6 +5,8 @@
 #include <array>
 #include <initializer_list>
 #include <span>
+#include <string>
+#include <vector>
 
 #include "number_types.h"
 #include "settings.h"
@@ -17,6 +19,12 @@ enum struct Level : usize {
 static_assert((usize)Level::Street == 0);
 static_assert((usize)Level::Bar    == 1);
 
+// see level_file.h for the format
+constexpr std::array<const char*, (usize)Level::Count> level_file_paths = {
+    "assets/levels/street.level",
+    "assets/levels/bar.level",
+};
+
 enum struct Border : usize {
     Top,
     Bottom,
@@ -24,32 +32,27 @@ enum struct Border : usize {
     Right
 };
 
+// different images of props in a single level
+const u32 LEVEL_MAX_PROP_IMGS = 8;
+
+// drawn on top of the bg and behind every entity
+struct Level_Prop {
+    u32 idx_img; // into Level_Info::prop_paths and Game::prop_imgs
+    f32 x;       // top left, in world coords
+    f32 y;
+};
+
 struct Level_Info {
+    // the borders, indexed by Border, they follow the camera
     std::array<SDL_FRect, 4> collision_boxes;
-    const char*              bg_path;
+    // colliders that never move (railings, door frames, ...), they go into g.level_bvh when the level is loaded
+    std::vector<SDL_FRect>   static_boxes;
+    std::string              bg_path;
+    std::vector<std::string> prop_paths; // every image once, even if several props use it
+    std::vector<Level_Prop>  props;
 };
 
 std::span<const SDL_FRect> level_info_get_collision_boxes(const Level_Info& li);
 SDL_FRect level_info_get_collision_box(const Level_Info& li, Border border);
 void level_info_update_collision_box(Level_Info& info, Border border, SDL_FRect box);
-Level_Info level_data_get_level(Level level);
-
-constexpr std::array<Level_Info, (usize)Level::Count> level_data = []() {
-    std::array<Level_Info, (usize)Level::Count> data{};
-
-    data[(usize)Level::Street] = {};
-    data[(usize)Level::Street].bg_path = "assets/art/backgrounds/street-background.png";
-    data[(usize)Level::Street].collision_boxes[(usize)Border::Top]    = {0,            0,  150, 30};
-    data[(usize)Level::Street].collision_boxes[(usize)Border::Bottom] = {0,            64, 150, 10};
-    data[(usize)Level::Street].collision_boxes[(usize)Border::Left]   = {-1,           0,  1,   64};
-    data[(usize)Level::Street].collision_boxes[(usize)Border::Right]  = {SCREEN_WIDTH, 0,  1,   64};
-
-    data[(usize)Level::Bar] = {};
-    data[(usize)Level::Bar].bg_path = "assets/art/backgrounds/bar-background.png";
-    data[(usize)Level::Bar].collision_boxes[(usize)Border::Top]    = {0,            0,  150, 32};
-    data[(usize)Level::Bar].collision_boxes[(usize)Border::Bottom] = {0,            64, 150, 10};
-    data[(usize)Level::Bar].collision_boxes[(usize)Border::Left]   = {-1,           0,  1,   64};
-    data[(usize)Level::Bar].collision_boxes[(usize)Border::Right]  = {SCREEN_WIDTH, 0,  1,   64};
-
-    return data;
-}();
+std::span<const SDL_FRect> level_info_get_static_boxes(const Level_Info& li);
@@ -11,6 +11,12 @@
 #include "settings.h"
 #include "draw.h"
 #include "debug_menu.h"
+#include "scenario.h"
+#include "bench.h"
+#include "asset_pack.h"
+#include "asset_loader.h"
+#include "perf.h"
+#include "activity.h"
 
 #include "entities/player.h"
 #include "entities/enemy.h"
@@ -19,8 +25,34 @@
 #include "entities/bullet.h"
 
 static Game g = {};
+static Settings_Args settings_args = {}; // kept for saving from the debug menu
+
+// a bar in the middle of the screen while the textures get uploaded
+static void draw_loading_progress(u32 loaded, u32 total, void* user) {
+    auto* r = (SDL_Renderer*)user;
+    SDL_SetRenderDrawColor(r, 0, 0, 0, 255);
+    SDL_RenderClear(r);
+
+    const SDL_FRect bar = {10.0f, SCREEN_HEIGHT / 2 - 1.0f, (SCREEN_WIDTH - 20.0f) * loaded / total, 2.0f};
+    SDL_SetRenderDrawColor(r, 230, 230, 230, 255);
+    SDL_RenderFillRect(r, &bar);
+    SDL_RenderPresent(r);
+}
+
+static bool init(const Scenario& scenario, const Bench& bench) {
+    if (bench.headless) {
+        SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+    }
+
+    // the tuned values, benchmarks run with the defaults unless they are given a file so that their reports stay comparable
+    const bool load_settings = settings_args.path_given || (!bench.enabled && SDL_GetPathInfo(settings_args.path, nullptr));
+    if (load_settings) {
+        Settings_Overrides overrides;
+        if (!settings_load(overrides, settings_args.path)) return false;
+        settings_apply(settings_pending, overrides);
+    }
+    settings_publish();
 
-static bool init() {
     if (!SDL_Init(SDL_INIT_VIDEO)) {
         SDL_Log("SDL could not initialize! SDL err: %s\n", SDL_GetError());
         return false;
@@ -59,189 +91,95 @@ static bool init() {
         }
     }
 
+    // without the pack (like during development) every asset is loaded from its loose file,
+    // in dev mode loose files saved after the pack was built win over it
+    asset_pack_open(asset_pack, ASSET_PACK_PATH, settings.dev_mode && !bench.enabled);
+
     if (!TTF_Init()) {
         SDL_Log("SDL_ttf could not initialize! SDL err: %s\n", SDL_GetError());
         return false;
     }
 
+    {
+        bool ok = level_load(g, Level::Street);
+        if (!ok) return false;
+    }
+
+    // the images get decoded on every core while the rest of init keeps going,
+    // the workers use the loader on this stack so every failure until the finish cancels it
+    Asset_Loader loader = {};
+    asset_loader_add_img(loader, g.bg,            g.curr_level_info.bg_path.c_str());
+    for (u32 idx = 0; idx < g.curr_level_info.prop_paths.size(); idx++) {
+        asset_loader_add_img(loader, g.prop_imgs[idx], g.curr_level_info.prop_paths[idx].c_str());
+    }
+    asset_loader_add_img(loader, g.entity_shadow, "assets/art/characters/shadow.png");
+    asset_loader_add_img(loader, g.spark,         "assets/art/particles/spark.png");
+    asset_loader_add_sprite(loader, g.sprite_player,       "assets/art/characters/player.png");
+    asset_loader_add_sprite(loader, g.sprite_barrel,       "assets/art/props/barrel.png");
+    asset_loader_add_sprite(loader, g.sprite_knife,        "assets/art/props/knife.png");
+    asset_loader_add_sprite(loader, g.sprite_gun,          "assets/art/props/gun.png");
+    asset_loader_add_sprite(loader, g.sprite_food,         "assets/art/props/chicken.png");
+    // the enemy and weapon sheets go through g.sheets, only the ones the level uses get loaded
+    asset_loader_start(loader);
+
     // load fonts
     {
-        g.font_tiny_mono = TTF_OpenFont("assets/fonts/tiny_mono.ttf", settings.font_size_default);
+        g.font_tiny_mono = TTF_OpenFontIO(asset_open_io("assets/fonts/tiny_mono.ttf"), true, settings.font_size_default);
         if (!g.font_tiny_mono) {
             SDL_Log("SDL_ttf could not load tiny_mono! SDL err: %s\n", SDL_GetError());
+            asset_loader_cancel(loader);
             return false;
         }
 
-        g.font_press_start_2p = TTF_OpenFont("assets/fonts/PressStart2P.ttf", settings.font_size_default);
+        g.font_press_start_2p = TTF_OpenFontIO(asset_open_io("assets/fonts/PressStart2P.ttf"), true, settings.font_size_default);
         if (!g.font_press_start_2p) {
             SDL_Log("SDL_ttf could not load PressStart2P! SDL err: %s\n", SDL_GetError());
+            asset_loader_cancel(loader);
             return false;
         }
     }
 
+    // rasterize every glyph once, strings are drawn from these
     {
-        g.curr_level_info = level_data_get_level(Level::Street);
-        g.camera = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
-        bool ok = img_load(g.bg, g.renderer, g.curr_level_info.bg_path);
-        if (!ok) {
-            SDL_Log("Failed to load bg img! SDL err: %s\n", SDL_GetError());
-            return false;
-        }
-    }
-
-    {
-        bool ok = img_load(g.entity_shadow, g.renderer, "assets/art/characters/shadow.png");
-        if (!ok) {
-            SDL_Log("Failed to load shadow img! SDL err: %s\n", SDL_GetError());
-            return false;
-        }
-    }
-
-    {
-        bool ok = sprite_load(g.sprite_player, g.renderer, "assets/art/characters/player.png");
+        bool ok = text_atlas_init(g.atlas_tiny_mono, g.renderer, g.font_tiny_mono);
         if (!ok) {
-            SDL_Log("Failed to load player sprite! SDL err: %s\n", SDL_GetError());
+            SDL_Log("Failed to build tiny_mono font atlas! SDL err: %s\n", SDL_GetError());
+            asset_loader_cancel(loader);
             return false;
         }
-    }
 
-    // player setup
-    {
-        player_init(&g.sprite_player, g);
-    }
-
-    {
-        bool ok = sprite_load(g.sprite_barrel, g.renderer, "assets/art/props/barrel.png");
+        ok = text_atlas_init(g.atlas_press_start_2p, g.renderer, g.font_press_start_2p);
         if (!ok) {
-            SDL_Log("Failed to load barrel sprite! SDL err: %s\n", SDL_GetError());
+            SDL_Log("Failed to build PressStart2P font atlas! SDL err: %s\n", SDL_GetError());
+            asset_loader_cancel(loader);
             return false;
         }
     }
 
-    {
-        barrel_init(g, {
-            .x = SCREEN_WIDTH / 2,
-            .y = 38,
-            .health = 20,
-            .sprite = &g.sprite_barrel,
-            .held_collectible = Collectible_Type::Knife,
-        });
-
-        barrel_init(g, {
-            .x = SCREEN_WIDTH,
-            .y = 38,
-            .health = 20,
-            .sprite = &g.sprite_barrel,
-            .held_collectible = Collectible_Type::Food,
-        });
-    }
-
-    {
-        bool ok = sprite_load(g.sprite_knife_player, g.renderer, "assets/art/characters/player_knife.png");
-        if (!ok) {
-            SDL_Log("Failed to load player_knife sprite! SDL err: %s\n", SDL_GetError());
-            return false;
-        }
-    }
+    // only recorded, the entities get created once the textures are there
+    spawn_buffer_init(g.spawns);
+    spawn_player(g, {.sprite = &g.sprite_player});
 
     {
-        bool ok = sprite_load(g.sprite_knife_enemy, g.renderer, "assets/art/characters/enemy_knife.png");
+        bool ok = asset_loader_finish(loader, g.renderer, draw_loading_progress, g.renderer);
         if (!ok) {
-            SDL_Log("Failed to load enemy_knife sprite! SDL err: %s\n", SDL_GetError());
+            SDL_Log("Failed to load the images!\n");
             return false;
         }
     }
 
-    {
-        bool ok = sprite_load(g.sprite_gun_player, g.renderer, "assets/art/characters/player_gun.png");
-        if (!ok) {
-            SDL_Log("Failed to load player_gun sprite! SDL err: %s\n", SDL_GetError());
-            return false;
-        }
-    }
-
-    {
-        bool ok = sprite_load(g.sprite_gun_enemy, g.renderer, "assets/art/characters/enemy_gun.png");
-        if (!ok) {
-            SDL_Log("Failed to load enemy_gun sprite! SDL err: %s\n", SDL_GetError());
-            return false;
-        }
-    }
-
-    {
-        bool ok = sprite_load(g.sprite_knife, g.renderer, "assets/art/props/knife.png");
-        if (!ok) {
-            SDL_Log("Failed to load knife sprite! SDL err: %s\n", SDL_GetError());
-            return false;
-        }
-    }
-
-    {
-        bool ok = sprite_load(g.sprite_gun, g.renderer, "assets/art/props/gun.png");
-        if (!ok) {
-            SDL_Log("Failed to load gun sprite! SDL err: %s\n", SDL_GetError());
-            return false;
-        }
-    }
-
-    {
-        bool ok = sprite_load(g.sprite_food, g.renderer, "assets/art/props/chicken.png");
-        if (!ok) {
-            SDL_Log("Failed to load gun sprite! SDL err: %s\n", SDL_GetError());
-            return false;
-        }
-    }
-
-    {
-        bool ok = sprite_load(g.sprite_enemy_goon, g.renderer, "assets/art/characters/enemy_goon.png");
-        if (!ok) {
-            SDL_Log("Failed to load enemy_goon sprite! SDL err: %s\n", SDL_GetError());
-            return false;
-        }
-
-        ok = sprite_load(g.sprite_enemy_punk, g.renderer, "assets/art/characters/enemy_punk.png");
-        if (!ok) {
-            SDL_Log("Failed to load enemy_punk sprite! SDL err: %s\n", SDL_GetError());
-            return false;
-        }
-
-        ok = sprite_load(g.sprite_enemy_thug, g.renderer, "assets/art/characters/enemy_thug.png");
-        if (!ok) {
-            SDL_Log("Failed to load enemy_thug sprite! SDL err: %s\n", SDL_GetError());
-            return false;
-        }
-
-        ok = sprite_load(g.sprite_enemy_boss, g.renderer, "assets/art/characters/enemy_boss.png");
-        if (!ok) {
-            SDL_Log("Failed to load enemy_boss sprite! SDL err: %s\n", SDL_GetError());
-            return false;
+    if (settings.dev_mode && !bench.enabled) {
+        for (u32 idx = 0; idx < loader.job_count; idx++) {
+            hot_reload_watch_img(g.hot_reload, *loader.jobs[idx].img, loader.jobs[idx].path);
         }
+        sheet_cache_watch_for_reload(g);
+        hot_reload_start(g.hot_reload, settings_args.path);
     }
 
-    {
-        const auto health = 200.0f;
-
-        // enemy_init(g, {
-        //     .type = Enemy_Type::Punk,
-        //     .health = health,
-        //     .damage = 10.0f,
-        //     .speed = 0.02f,
-        //     .x = SCREEN_WIDTH - 0.2f * SCREEN_WIDTH,
-        //     .y = 55,
-        // });
-
-        enemy_init(g, {
-            .type = Enemy_Type::Goon,
-            .health = health,
-            .damage = 10.0f,
-            .speed = 0.02f,
-            .x = SCREEN_WIDTH - 0.2f * SCREEN_WIDTH,
-            .y = 55,
-            .has_knife = false,
-            .can_spawn_knives = false,
-            .has_gun = true,
-        });
-    }
+    // the generated layouts are spread over the width of the bg
+    scenario_spawn(g, scenario);
+    level_waves_update(g);
+    spawn_buffer_apply(g);
 
     return true;
 }
@@ -265,10 +203,6 @@ static Update_Result update_entity(Entity& e) {
         case Entity_Type::Collectible: {
             res = collectible_update(e, g);
         } break;
-
-        case Entity_Type::Bullet: {
-            res = bullet_update(e, g);
-        } break;
     }
 
     return res;
@@ -283,74 +217,71 @@ static void y_sort_entities(Game& g) {
         }
     }
 
-    auto sort_fn = [g](u32 a, u32 b) { return g.entities[a].y < g.entities[b].y; };
+    auto sort_fn = [&g](u32 a, u32 b) { return g.entities[a].y < g.entities[b].y; };
     std::sort(g.sorted_indices.begin(), g.sorted_indices.end(), sort_fn);
 }
 
-static void handle_prop_queues(Game& g) {
-    while (!g.props_thrown_queue.empty()) {
-        const auto prop_info = g.props_thrown_queue.back();
-
-        auto collectible = collectible_init(g, {
-            .type     = prop_info.type,
-            .state    = Collectible_State::Thrown,
-            .position = prop_info.position,
-            .dir      = prop_info.dir,
-            .done_by  = prop_info.thrown_by,
-        });
-        g.entities.push_back(collectible);
+static void update(Game& g) {
+    Perf_Zone zone("update");
+    g.tick++;
 
-        g.props_thrown_queue.pop_back();
+    {
+        Perf_Zone zone_activity("activity");
+        activity_update(g);
     }
-
-    while (!g.props_dropped_queue.empty()) {
-        const auto prop_info = g.props_dropped_queue.back();
-
-        auto collectible = collectible_init(g, {
-            .type                = prop_info.type,
-            .state               = Collectible_State::Dropped,
-            .position            = prop_info.position,
-            .dir                 = prop_info.dir, // could be whatever [...] this in fact, could not be whatever
-            .done_by             = prop_info.dropped_by,
-            .instantly_disappear = prop_info.instantly_disappear,
-        });
-        g.entities.push_back(collectible);
-
-        g.props_dropped_queue.pop_back();
+    {
+        Perf_Zone zone_grid("spatial_grid");
+        game_build_spatial_grid(g);
+    }
+    {
+        Perf_Zone zone_flow("flow_field");
+        flow_field_update(g.flow, g);
+    }
+    attack_slots_update(g);
+    {
+        Perf_Zone zone_anims("animations");
+        animation_system_update(animations, g.dt, g.dt_real);
     }
-}
 
-static void update(Game& g) {
     for (u64 idx = 0; idx < g.entities.size(); idx++) {
         auto& entity = g.entities[idx];
+        if (entity.sleeping) continue;
         auto res = update_entity(entity);
 
         switch (res) {
             case Update_Result::None: break;
 
             case Update_Result::Remove_Me: {
-                g.removal_queue.push_back(idx);
+                despawn(g, idx);
             } break;
         }
     }
 
-    while (!g.removal_queue.empty()) {
-        const auto idx = g.removal_queue.back();
-        g.entities.erase(g.entities.begin() + idx);
-        g.removal_queue.pop_back();
+    bullet_pool_update(g.bullets, g.time_ms);
+    {
+        Perf_Zone zone_particles("particles");
+        particles_update(g.particles, g.dt);
     }
 
-    handle_prop_queues(g);
-    y_sort_entities(g);
+    {
+        Perf_Zone zone_spawns("spawns");
+        level_waves_update(g);
+        spawn_buffer_apply(g);
+    }
+    {
+        Perf_Zone zone_sort("y_sort");
+        y_sort_entities(g);
+    }
 
     g.input_prev  = g.input;
     g.input.attack = false;
     g.input.interact = false;
 
-    debug_menu_update(g.menu);
+    Perf_Zone zone_menu("debug_menu");
+    debug_menu_update(g.menu, g);
 }
 
-static void draw_entity(SDL_Renderer* r, Entity e) {
+static void draw_entity(SDL_Renderer* r, const Entity& e) {
     switch (e.type) {
         case Entity_Type::Player: {
             player_draw(r, e, g);
@@ -367,14 +298,12 @@ static void draw_entity(SDL_Renderer* r, Entity e) {
         case Entity_Type::Collectible: {
             collectible_draw(r, e, g);
         } break;
-
-        case Entity_Type::Bullet: {
-            bullet_draw(r, e, g);
-        } break;
     }
 }
 
 static void draw(const Game& g) {
+    Perf_Zone zone("draw");
+
     SDL_RenderClear(g.renderer);
 
     draw_level(g.renderer, g);
@@ -382,6 +311,8 @@ static void draw(const Game& g) {
     for (u32 idx_sorted : g.sorted_indices) {
         draw_entity(g.renderer, g.entities[idx_sorted]);
     }
+    bullet_pool_draw(g.renderer, g.bullets, g);
+    particles_draw(g.renderer, g.particles, g.spark, {g.camera.x, g.camera.y});
 
     debug_menu_draw(g.menu, g.renderer);
 
@@ -403,6 +334,44 @@ Key_Binding bindings[] = {
     {SDLK_SPACE, &g.input.jump},
 };
 
+// Everything but the player is dropped and the level starts over from its first wave,
+// has to be called outside of update since it applies the spawn buffer.
+static bool change_level(Game& g, Level level) {
+    for (u32 idx = 0; idx < g.entities.size(); idx++) {
+        if (idx != g.idx_player) despawn(g, idx);
+    }
+    spawn_buffer_apply(g);
+    g.bullets.count   = 0;
+    g.particles.count = 0;
+
+    if (!level_load(g, level)) return false;
+    // the enemies of the old level are gone, so are the references to their sheets
+    sheet_cache_evict_unused(g);
+
+    SDL_DestroyTexture(g.bg.img);
+    if (!img_load(g.bg, g.renderer, g.curr_level_info.bg_path.c_str())) return false;
+    hot_reload_watch_img(g.hot_reload, g.bg, g.curr_level_info.bg_path.c_str());
+
+    for (auto& img : g.prop_imgs) {
+        if (img.img) SDL_DestroyTexture(img.img);
+        img = {};
+    }
+    for (u32 idx = 0; idx < g.curr_level_info.prop_paths.size(); idx++) {
+        const char* path = g.curr_level_info.prop_paths[idx].c_str();
+        if (!img_load(g.prop_imgs[idx], g.renderer, path)) return false;
+        hot_reload_watch_img(g.hot_reload, g.prop_imgs[idx], path);
+    }
+
+    auto& player = game_get_player_mutable(g);
+    player.x = 30;
+    player.y = 50;
+    attack_slots_init(player.extra_player.slots, entity_get_pos(player));
+
+    level_waves_update(g);
+    spawn_buffer_apply(g);
+    return true;
+}
+
 static void handle_input(const SDL_Event& e) {
     bool pressed = (e.type == SDL_EVENT_KEY_DOWN);
     for (auto& binding : bindings) {
@@ -412,21 +381,66 @@ static void handle_input(const SDL_Event& e) {
         }
     }
 
-    // toggle debug menu
-    if (e.key.key == SDLK_TAB) {
+    // toggle debug menu, only on the press so that the release doesnt toggle it right back
+    if (e.key.key == SDLK_TAB && pressed && !e.key.repeat) {
         g.menu.show = !g.menu.show;
     }
 
     if (e.key.key == SDLK_Q && e.type == SDL_EVENT_KEY_DOWN) {
-        settings.time_scale = (settings.time_scale == 1.0f) ? 0.2f : 1.0f;
+        settings_pending.time_scale = (settings_pending.time_scale == 1.0f) ? 0.2f : 1.0f;
+    }
+
+    // cycles through the levels, for checking the loading and unloading of their assets
+    if (e.key.key == SDLK_L && pressed && !e.key.repeat && g.menu.show) {
+        const Level next = (Level)(((usize)g.curr_level + 1) % (usize)Level::Count);
+        if (!change_level(g, next)) SDL_Log("Failed to change the level!\n");
+    }
+
+    // everything tuned so far, like with the time scale toggle, goes into the settings file
+    if (e.key.key == SDLK_P && pressed && !e.key.repeat && g.menu.show) {
+        if (settings_save(settings_pending, settings_args.path)) SDL_Log("Saved the settings to %s\n", settings_args.path);
     }
 }
 
-int main() {
-    if (!init()) {
+static void step(Game& g, Scenario& scenario, u64 dt_real) {
+    // everything that changed since the last frame takes effect at once
+    settings_publish();
+    perf_frame_begin();
+
+    g.dt_real = dt_real;
+    g.dt = g.dt_real * settings.time_scale;
+    g.time_ms += g.dt;
+    scenario_update(g, scenario);
+    update(g);
+    draw(g);
+
+    perf_frame_end();
+}
+
+int main(int argc, char** argv) {
+    Scenario scenario = {};
+    if (!scenario_parse_args(scenario, argc, argv)) {
+        return 1;
+    }
+
+    Bench bench = {};
+    if (!bench_parse_args(bench, argc, argv)) {
         return 1;
     }
 
+    if (!settings_parse_args(settings_args, argc, argv)) {
+        return 1;
+    }
+
+    if (!init(scenario, bench)) {
+        return 1;
+    }
+
+    if (bench.enabled) {
+        perf.record_frame_times = true;
+        perf.frame_times_ns.reserve(bench.frames);
+    }
+
     bool quit = false;
     u64  a    = SDL_GetTicks();
     u64  b    = SDL_GetTicks();
@@ -450,19 +464,32 @@ int main() {
             }
         }
 
-        a = SDL_GetTicks();
-        g.dt_real = a - b;
+        // between two frames, so that nothing sees a texture or a setting change halfway through one
+        hot_reload_apply(g.hot_reload, g.renderer);
 
         const u64 max_cap = 1000 / settings.fps_max;
-        if (g.dt_real > max_cap) {
-            g.dt_real = max_cap;
+
+        // fixed dt without waiting on the clock, so that every run simulates exactly the same frames
+        if (bench.enabled) {
+            step(g, scenario, max_cap);
+            if (perf.frame_count >= bench.frames) quit = true;
+            continue;
+        }
+
+        a = SDL_GetTicks();
+        if (a - b > max_cap) {
             b = a;
-            g.dt = g.dt_real * settings.time_scale;
-            g.time_ms += g.dt;
-            update(g);
-            draw(g);
+            step(g, scenario, max_cap);
         }
     }
 
+    hot_reload_stop(g.hot_reload);
+    // nothing gets drawn or loaded anymore, so the fonts that stream from the mapping are done with it
+    asset_pack_close(asset_pack);
+
+    if (bench.enabled && !bench_write_report(bench, scenario)) {
+        return 1;
+    }
+
     return 0;
 }
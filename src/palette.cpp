@@ -0,0 +1,161 @@
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <span>
+
+#include <SDL3_image/SDL_image.h>
+
+#include "palette.h"
+#include "asset_pack.h"
+
+static bool palette_parse_color(const char* str, SDL_Color& out) {
+    unsigned int rgb = 0;
+    int          read = 0;
+    if (std::sscanf(str, "%6x%n", &rgb, &read) != 1 || read != 6) return false;
+    out = {(Uint8)(rgb >> 16), (Uint8)(rgb >> 8), (Uint8)rgb, 255};
+    return true;
+}
+
+bool palette_load(Palette& p, const char* path) {
+    return palette_load_io(p, asset_open_io(path), path);
+}
+
+bool palette_load_io(Palette& p, SDL_IOStream* io, const char* path) {
+    // null terminated by SDL, parsed in place
+    char* text = io ? (char*)SDL_LoadFile_IO(io, nullptr, true) : nullptr;
+    if (!text) {
+        SDL_Log("Failed to read palette %s! SDL err: %s\n", path, SDL_GetError());
+        return false;
+    }
+
+    p = {};
+    u32   line_number = 0;
+    char* curr        = text;
+    bool  ok          = true;
+    while (curr && ok) {
+        line_number++;
+        char* next = std::strchr(curr, '\n');
+        if (next) *next++ = '\0';
+        char* comment = std::strchr(curr, '#');
+        if (comment) *comment = '\0';
+
+        char from[16] = {};
+        char to[16]   = {};
+        char extra[2] = {};
+        const int words = std::sscanf(curr, "%15s %15s %1s", from, to, extra);
+        if (words > 0) {
+            ok = words == 2 && p.count < PALETTE_MAX_SWAPS
+                && palette_parse_color(from, p.swaps[p.count].from)
+                && palette_parse_color(to,   p.swaps[p.count].to);
+            if (ok) p.count++;
+            else    SDL_Log("Malformed line %u in palette %s\n", line_number, path);
+        }
+
+        curr = next;
+    }
+
+    SDL_free(text);
+    return ok;
+}
+
+// the rgba pixels of the sheet, from the pack without decoding if it has them, caller destroys it
+static SDL_Surface* palette_decode_sheet(const char* path) {
+    const auto* entry = asset_pack_find(asset_pack, path);
+    if (entry && entry->kind == Asset_Kind::Pixels) {
+        const auto pixels = asset_pack_bytes(asset_pack, *entry);
+        // the pack is mapped read only, the surface is only ever read from
+        SDL_Surface* mapped = SDL_CreateSurfaceFrom(entry->width, entry->height, ASSET_PACK_PIXEL_FORMAT, (void*)pixels.data(), entry->width * 4);
+        if (!mapped) return nullptr;
+        SDL_Surface* copy = SDL_ConvertSurface(mapped, SDL_PIXELFORMAT_RGBA32);
+        SDL_DestroySurface(mapped);
+        return copy;
+    }
+
+    SDL_Surface* loaded = IMG_Load(path);
+    if (!loaded) return nullptr;
+    SDL_Surface* converted = SDL_ConvertSurface(loaded, SDL_PIXELFORMAT_RGBA32);
+    SDL_DestroySurface(loaded);
+    return converted;
+}
+
+// a swap changes one entry of the index palette instead of every pixel with that color
+static void palette_apply_swaps(std::span<SDL_Color> colors, const Palette& p) {
+    for (auto& c : colors) {
+        for (u32 idx_swap = 0; idx_swap < p.count; idx_swap++) {
+            const auto& swap = p.swaps[idx_swap];
+            if (c.r != swap.from.r || c.g != swap.from.g || c.b != swap.from.b) continue;
+            c = {swap.to.r, swap.to.g, swap.to.b, c.a};
+            break;
+        }
+    }
+}
+
+// One byte per pixel, the colors of the sheet in the order they first appear with the swaps already applied.
+// returns nullptr if the sheet has more colors than fit into a palette
+SDL_Surface* palette_index_sheet(SDL_Surface* rgba, const Palette& p) {
+    SDL_Surface* indexed = SDL_CreateSurface(rgba->w, rgba->h, SDL_PIXELFORMAT_INDEX8);
+    if (!indexed) return nullptr;
+    SDL_Palette* palette = SDL_CreatePalette(PALETTE_MAX_COLORS);
+    if (!palette) {
+        SDL_DestroySurface(indexed);
+        return nullptr;
+    }
+
+    std::array<SDL_Color, PALETTE_MAX_COLORS> colors = {};
+    u32 color_count = 0;
+    u32 idx_last    = 0; // neighbouring pixels mostly have the same color
+    bool ok = true;
+    for (int y = 0; y < rgba->h && ok; y++) {
+        const u8* src = (const u8*)rgba->pixels + y * rgba->pitch;
+        u8*       dst = (u8*)indexed->pixels + y * indexed->pitch;
+        for (int x = 0; x < rgba->w; x++) {
+            const SDL_Color c = {src[4*x], src[4*x + 1], src[4*x + 2], src[4*x + 3]};
+            auto same = [&c](const SDL_Color& o) { return o.r == c.r && o.g == c.g && o.b == c.b && o.a == c.a; };
+
+            if (color_count == 0 || !same(colors[idx_last])) {
+                u32 idx = 0;
+                while (idx < color_count && !same(colors[idx])) idx++;
+                if (idx == color_count) {
+                    if (color_count == PALETTE_MAX_COLORS) {
+                        ok = false;
+                        break;
+                    }
+                    colors[color_count++] = c;
+                }
+                idx_last = idx;
+            }
+            dst[x] = (u8)idx_last;
+        }
+    }
+
+    palette_apply_swaps(std::span(colors).first(color_count), p);
+    ok = ok && SDL_SetPaletteColors(palette, colors.data(), 0, color_count) && SDL_SetSurfacePalette(indexed, palette);
+    // the surface keeps its own reference
+    SDL_DestroyPalette(palette);
+    if (!ok) {
+        SDL_DestroySurface(indexed);
+        return nullptr;
+    }
+    return indexed;
+}
+
+bool sprite_load_with_palette(Sprite& s, SDL_Renderer* r, const char* path, const Palette& p) {
+    assert(s.max_frames_in_row_count   > 0);
+    assert(s.frames_in_each_row.size() > 0);
+
+    SDL_Surface* rgba = palette_decode_sheet(path);
+    if (!rgba) {
+        SDL_Log("Could not decode %s! SDL err: %s\n", path, SDL_GetError());
+        return false;
+    }
+    SDL_Surface* indexed = palette_index_sheet(rgba, p);
+    SDL_DestroySurface(rgba);
+    if (!indexed) {
+        SDL_Log("Could not index %s, it needs to have at most %u colors\n", path, PALETTE_MAX_COLORS);
+        return false;
+    }
+
+    bool ok = img_load_from_surface(s.img, r, indexed);
+    SDL_DestroySurface(indexed);
+    return ok;
+}
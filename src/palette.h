@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <SDL3/SDL.h>
+
+#include "number_types.h"
+#include "sprite.h"
+
+// a sheet is indexed into at most this many colors, transparent ones included
+const u32 PALETTE_MAX_COLORS = 256;
+const u32 PALETTE_MAX_SWAPS  = 64;
+
+struct Palette_Swap {
+    SDL_Color from; // only rgb is compared, the alpha of the sheet is kept
+    SDL_Color to;
+};
+
+// The colors of a variant that differ from its base sheet. A palette file has one swap per line,
+// "rrggbb rrggbb" from the color in the sheet to the one of the variant, # starts a comment.
+struct Palette {
+    std::array<Palette_Swap, PALETTE_MAX_SWAPS> swaps;
+    u32                                         count;
+};
+
+// returns false if the file cant be read or has a malformed line
+bool palette_load(Palette& p, const char* path);
+// Closes io, only allocates through SDL so it can be called from any thread.
+bool palette_load_io(Palette& p, SDL_IOStream* io, const char* path);
+
+// An INDEX8 copy of rgba (which has to be RGBA32) with the swaps applied to its palette, caller destroys it.
+// returns nullptr if the sheet has more than PALETTE_MAX_COLORS colors
+SDL_Surface* palette_index_sheet(SDL_Surface* rgba, const Palette& p);
+
+// Indexes the sheet at path by its colors, swaps the colors of that index palette and uploads the result.
+// The renderer has no palette textures, so the upload is a whole new texture that doesnt share anything
+// with the one of the base sheet. The sprite metadata has to be initialized already, like for sprite_load.
+//
+// returns false on error
+bool sprite_load_with_palette(Sprite& s, SDL_Renderer* r, const char* path, const Palette& p);
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#include "particles.h"
+#include "settings.h"
+#include "perf.h"
+#include "utils.h"
+
+static f32 rand_range(u64& state, f32 min, f32 max) {
+    return min + SDL_randf_r(&state) * (max - min);
+}
+
+void particles_emit_sparks(Particle_Pool& p, Particle_Emit_Opts opts) {
+    constexpr f32 pi = std::numbers::pi_v<f32>;
+
+    // y grows downwards, so up is -pi/2
+    f32 angle_center;
+    f32 angle_spread;
+    switch (opts.dir) {
+        case Direction::Right: { angle_center = 0.0f;      angle_spread = pi / 2.5f; } break;
+        case Direction::Left:  { angle_center = pi;        angle_spread = pi / 2.5f; } break;
+        case Direction::Up:    { angle_center = -pi / 2;   angle_spread = pi / 2;    } break;
+        case Direction::Down:  { angle_center = pi / 2;    angle_spread = pi / 2;    } break;
+        default:               unreachable("not a direction");
+    }
+
+    const u64 count = std::min<u64>(opts.count, PARTICLE_POOL_CAPACITY - p.count);
+    for (u64 n = 0; n < count; n++) {
+        const u32 idx   = p.count++;
+        const f32 angle = angle_center + rand_range(p.rng, -angle_spread, angle_spread);
+        const f32 speed = settings.spark_velocity * rand_range(p.rng, 0.4f, 1.0f);
+
+        p.x[idx]           = opts.pos.x;
+        p.y[idx]           = opts.pos.y;
+        p.x_vel[idx]       = std::cos(angle) * speed;
+        p.y_vel[idx]       = std::sin(angle) * speed;
+        p.age_ms[idx]      = 0.0f;
+        p.lifetime_ms[idx] = settings.spark_lifetime_ms * rand_range(p.rng, 0.6f, 1.0f);
+        p.size[idx]        = rand_range(p.rng, settings.spark_size_min, settings.spark_size_max);
+    }
+}
+
+void particles_update(Particle_Pool& p, u64 dt) {
+    const f32 dt_f    = (f32)dt;
+    const f32 gravity = settings.gravity;
+    const u32 count   = p.count;
+
+    // no branches and no aliasing between the arrays, so the compiler can vectorize these
+    f32* __restrict x     = p.x.data();
+    f32* __restrict y     = p.y.data();
+    f32* __restrict x_vel = p.x_vel.data();
+    f32* __restrict y_vel = p.y_vel.data();
+    f32* __restrict age   = p.age_ms.data();
+    for (u32 idx = 0; idx < count; idx++) y_vel[idx] += gravity * dt_f;
+    for (u32 idx = 0; idx < count; idx++) x[idx]     += x_vel[idx] * dt_f;
+    for (u32 idx = 0; idx < count; idx++) y[idx]     += y_vel[idx] * dt_f;
+    for (u32 idx = 0; idx < count; idx++) age[idx]   += dt_f;
+
+    // the dead ones get replaced by the last live one, the order doesnt matter
+    u32 idx = 0;
+    while (idx < p.count) {
+        if (p.age_ms[idx] < p.lifetime_ms[idx]) {
+            idx++;
+            continue;
+        }
+
+        const u32 last = --p.count;
+        p.x[idx]           = p.x[last];
+        p.y[idx]           = p.y[last];
+        p.x_vel[idx]       = p.x_vel[last];
+        p.y_vel[idx]       = p.y_vel[last];
+        p.age_ms[idx]      = p.age_ms[last];
+        p.lifetime_ms[idx] = p.lifetime_ms[last];
+        p.size[idx]        = p.size[last];
+    }
+}
+
+void particles_draw(SDL_Renderer* r, const Particle_Pool& p, const Img& spark, Vec2<f32> camera) {
+    if (p.count == 0) return;
+    assert(spark.height > 0.0f);
+
+    // kept around so that drawing doesnt allocate once they are big enough
+    static std::vector<SDL_Vertex> vertices;
+    static std::vector<int>        indices;
+    vertices.clear();
+    indices.clear();
+    vertices.reserve(4 * p.count);
+    indices.reserve(6 * p.count);
+
+    const u32 frame_count = std::max(1u, (u32)(spark.width / spark.height));
+    const f32 frame_u     = 1.0f / frame_count;
+
+    for (u32 idx = 0; idx < p.count; idx++) {
+        const f32 life  = p.age_ms[idx] / p.lifetime_ms[idx];
+        const u32 frame = std::min(frame_count - 1, (u32)(life * frame_count));
+        const f32 u1    = frame * frame_u;
+        const f32 u2    = u1 + frame_u;
+
+        const f32 half = p.size[idx] / 2;
+        const f32 x1   = p.x[idx] - camera.x - half;
+        const f32 y1   = p.y[idx] - camera.y - half;
+        const f32 x2   = x1 + p.size[idx];
+        const f32 y2   = y1 + p.size[idx];
+
+        const SDL_FColor color = {1.0f, 1.0f, 1.0f, 1.0f - life};
+
+        const int first = (int)vertices.size();
+        vertices.push_back({{x1, y1}, color, {u1, 0.0f}});
+        vertices.push_back({{x2, y1}, color, {u2, 0.0f}});
+        vertices.push_back({{x1, y2}, color, {u1, 1.0f}});
+        vertices.push_back({{x2, y2}, color, {u2, 1.0f}});
+
+        const int quad[6] = {0, 1, 2, 1, 2, 3};
+        for (int idx_quad : quad) indices.push_back(first + idx_quad);
+    }
+
+    bool ok = SDL_RenderGeometry(r, spark.img, vertices.data(), vertices.size(), indices.data(), indices.size());
+    if (!ok) SDL_Log("Failed to draw particles! SDL err: %s\n", SDL_GetError());
+    perf_count_draw_call(spark.img);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <SDL3/SDL.h>
+
+#include "number_types.h"
+#include "sprite.h"
+#include "vec2.h"
+#include "entities/entity.h"
+
+// live particles at the same time, emitting into a full pool does nothing
+const u32 PARTICLE_POOL_CAPACITY = 4096;
+
+// Every field is its own array and the live particles are packed at the start,
+// so integrating is a few straight loops over floats.
+struct Particle_Pool {
+    u32 count = 0;
+    u64 rng   = 0x5eed; // emitters draw from this, same hits give the same particles
+    // world coordinates, the height above the ground is already added to y
+    std::array<f32, PARTICLE_POOL_CAPACITY> x;
+    std::array<f32, PARTICLE_POOL_CAPACITY> y;
+    std::array<f32, PARTICLE_POOL_CAPACITY> x_vel;
+    std::array<f32, PARTICLE_POOL_CAPACITY> y_vel;
+    std::array<f32, PARTICLE_POOL_CAPACITY> age_ms;
+    std::array<f32, PARTICLE_POOL_CAPACITY> lifetime_ms;
+    std::array<f32, PARTICLE_POOL_CAPACITY> size;
+};
+
+struct Particle_Emit_Opts {
+    Vec2<f32> pos;
+    // the sparks fly mostly this way, Up for all around
+    Direction dir;
+    u64       count;
+};
+
+void particles_emit_sparks(Particle_Pool& p, Particle_Emit_Opts opts);
+void particles_update(Particle_Pool& p, u64 dt);
+// All of the particles in a single draw call, every frame of the spark
+// image has to be a square, the particles go through them as they age.
+void particles_draw(SDL_Renderer* r, const Particle_Pool& p, const Img& spark, Vec2<f32> camera);
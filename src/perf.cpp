@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include <SDL3/SDL.h>
+
+#include "perf.h"
+#include "settings.h"
+
+Perf perf{};
+
+void perf_frame_begin() {
+    perf.frame          = {};
+    perf.frame_start_ns = SDL_GetTicksNS();
+
+    for (usize idx = 0; idx < perf.zone_count; idx++) {
+        auto& zone = perf.zones[idx];
+        zone.allocs      = 0;
+        zone.alloc_bytes = 0;
+        zone.time_ns     = 0;
+    }
+}
+
+static void perf_check_alloc_budget() {
+    if (!PERF_TRACK_ALLOCATIONS || !settings.dev_mode) return;
+    if (perf.frame.allocs <= settings.dev_frame_alloc_budget) return;
+
+    SDL_Log("Frame %llu made %llu allocations (%llu B), the budget is %llu\n",
+        (unsigned long long)perf.frame_count,
+        (unsigned long long)perf.frame.allocs,
+        (unsigned long long)perf.frame.alloc_bytes,
+        (unsigned long long)settings.dev_frame_alloc_budget);
+    for (usize idx = 0; idx < perf.zone_count; idx++) {
+        const auto& zone = perf.zones[idx];
+        SDL_Log("    %s: %llu (%llu B)\n", zone.name, (unsigned long long)zone.allocs, (unsigned long long)zone.alloc_bytes);
+    }
+    assert(false && "frame went over the allocation budget");
+}
+
+void perf_frame_end() {
+    perf.frame_time_ns = SDL_GetTicksNS() - perf.frame_start_ns;
+    perf.frame_count++;
+
+    perf.total.draw_calls       += perf.frame.draw_calls;
+    perf.total.texture_switches += perf.frame.texture_switches;
+    perf.total.collision_tests  += perf.frame.collision_tests;
+    perf.total.allocs           += perf.frame.allocs;
+    perf.total.alloc_bytes      += perf.frame.alloc_bytes;
+    perf.last_frame              = perf.frame;
+
+    for (usize idx = 0; idx < perf.zone_count; idx++) {
+        const auto& zone = perf.zones[idx];
+        auto& total = perf.zones_total[idx];
+        total.name         = zone.name;
+        total.allocs      += zone.allocs;
+        total.alloc_bytes += zone.alloc_bytes;
+        total.time_ns     += zone.time_ns;
+    }
+    perf.zones_last_frame = perf.zones;
+
+    if (perf.record_frame_times) {
+        perf.frame_times_ns.push_back(perf.frame_time_ns);
+    }
+
+    perf_check_alloc_budget();
+}
+
+void perf_count_draw_call(const void* texture) {
+    perf.frame.draw_calls++;
+    if (texture != perf.last_texture) {
+        perf.frame.texture_switches++;
+        perf.last_texture = texture;
+    }
+}
+
+void perf_count_alloc(usize bytes) {
+    // runs inside of operator new, so this must not allocate
+    perf.frame.allocs++;
+    perf.frame.alloc_bytes += bytes;
+
+    if (perf.zone_current >= 0) {
+        auto& zone = perf.zones[perf.zone_current];
+        zone.allocs++;
+        zone.alloc_bytes += bytes;
+    }
+}
+
+static i32 perf_zone_find_or_register(const char* name) {
+    for (usize idx = 0; idx < perf.zone_count; idx++) {
+        if (std::strcmp(perf.zones[idx].name, name) == 0) return (i32)idx;
+    }
+
+    assert(perf.zone_count < PERF_ZONE_MAX && "too many perf zones, increase PERF_ZONE_MAX");
+    if (perf.zone_count == PERF_ZONE_MAX) return -1;
+
+    perf.zones[perf.zone_count]      = {};
+    perf.zones[perf.zone_count].name = name;
+    return (i32)perf.zone_count++;
+}
+
+Perf_Zone::Perf_Zone(const char* name) {
+    idx        = perf_zone_find_or_register(name);
+    idx_parent = perf.zone_current;
+    start_ns   = SDL_GetTicksNS();
+    if (idx >= 0) perf.zone_current = idx;
+}
+
+Perf_Zone::~Perf_Zone() {
+    if (idx >= 0) perf.zones[idx].time_ns += SDL_GetTicksNS() - start_ns;
+    perf.zone_current = idx_parent;
+}
+
+static f64 percentile_ms(const std::vector<u64>& sorted_ns, f64 perc) {
+    if (sorted_ns.empty()) return 0.0;
+
+    const auto idx = (usize)(perc * (sorted_ns.size() - 1) + 0.5);
+    return sorted_ns[idx] / 1'000'000.0;
+}
+
+Perf_Frame_Time_Percentiles perf_frame_time_percentiles(const Perf& p) {
+    auto sorted_ns = p.frame_times_ns;
+    std::sort(sorted_ns.begin(), sorted_ns.end());
+
+    return {
+        .p50_ms = percentile_ms(sorted_ns, 0.50),
+        .p95_ms = percentile_ms(sorted_ns, 0.95),
+        .p99_ms = percentile_ms(sorted_ns, 0.99),
+    };
+}
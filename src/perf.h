@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "number_types.h"
+
+// Set by the FOF_TRACK_ALLOCATIONS cmake option, which replaces the global operator new/delete
+// (alloc_tracking.cpp). Without it the alloc counters stay at 0.
+#ifdef FOF_TRACK_ALLOCATIONS
+constexpr bool PERF_TRACK_ALLOCATIONS = true;
+#else
+constexpr bool PERF_TRACK_ALLOCATIONS = false;
+#endif
+
+const usize PERF_ZONE_MAX = 16;
+
+struct Perf_Counters {
+    u64 draw_calls;
+    u64 texture_switches;
+    u64 collision_tests;
+    u64 allocs;
+    u64 alloc_bytes;
+};
+
+struct Perf_Zone_Stats {
+    const char* name;
+    // allocations made while this was the innermost zone
+    u64         allocs;
+    u64         alloc_bytes;
+    // including nested zones
+    u64         time_ns;
+};
+
+using Perf_Zones = std::array<Perf_Zone_Stats, PERF_ZONE_MAX>;
+
+struct Perf {
+    // reset at the start of every frame
+    Perf_Counters frame;
+    // the counters of the last finished frame, for displaying them while the next one is running
+    Perf_Counters last_frame;
+    // summed over every finished frame
+    Perf_Counters total;
+
+    u64 frame_count;
+    u64 frame_start_ns;
+    // duration of the last finished frame (update + draw)
+    u64 frame_time_ns;
+
+    // zones are registered the first time they are entered and keep their index after that,
+    // `zones` is reset at the start of every frame (except for the names)
+    Perf_Zones zones;
+    Perf_Zones zones_last_frame;
+    Perf_Zones zones_total;
+    usize      zone_count;
+    // innermost zone that is currently running, -1 outside of every zone
+    i32        zone_current = -1;
+
+    // texture of the last draw call, for detecting switches that break batching
+    const void* last_texture;
+
+    // only filled when enabled, so that a normal session doesnt grow it forever
+    bool             record_frame_times = false;
+    std::vector<u64> frame_times_ns;
+};
+
+extern Perf perf;
+
+void perf_frame_begin();
+void perf_frame_end();
+
+// `texture` is null for untextured draws (rects, lines, plain geometry)
+void perf_count_draw_call(const void* texture = nullptr);
+
+struct Perf_Frame_Time_Percentiles {
+    f64 p50_ms;
+    f64 p95_ms;
+    f64 p99_ms;
+};
+
+// Called by the allocator hook for every allocation.
+void perf_count_alloc(usize bytes);
+
+// Measures the time of its scope and counts the allocations made in it.
+//
+// `name` has to outlive the program, so pass a string literal.
+struct Perf_Zone {
+    i32 idx;
+    i32 idx_parent;
+    u64 start_ns;
+
+    explicit Perf_Zone(const char* name);
+    ~Perf_Zone();
+
+    Perf_Zone(const Perf_Zone&)            = delete;
+    Perf_Zone& operator=(const Perf_Zone&) = delete;
+};
+
+// Only meaningful when `record_frame_times` was enabled.
+Perf_Frame_Time_Percentiles perf_frame_time_percentiles(const Perf& p);
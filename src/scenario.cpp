@@ -0,0 +1,264 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include <SDL3/SDL.h>
+
+#include "scenario.h"
+#include "game.h"
+#include "level_info.h"
+#include "entities/enemy.h"
+#include "entities/barrel.h"
+#include "entities/bullet.h"
+#include "entities/collectible.h"
+
+struct Scenario_Preset {
+    const char* name;
+    u32         entity_count; // 0 means the waves of the level file
+};
+
+static constexpr Scenario_Preset presets[] = {
+    {"default",      0},
+    {"stress-10",    10},
+    {"stress-100",   100},
+    {"stress-1000",  1000},
+    {"stress-10000", 10000},
+};
+
+static constexpr Enemy_Type enemy_types[] = {
+    Enemy_Type::Goon,
+    Enemy_Type::Punk,
+    Enemy_Type::Thug,
+    Enemy_Type::Boss,
+};
+
+static constexpr Collectible_Type collectible_types[] = {
+    Collectible_Type::Knife,
+    Collectible_Type::Gun,
+    Collectible_Type::Food,
+};
+
+// splits the total amount of entities of a preset into the mix that is spawned
+static void scenario_apply_preset(Scenario& s, const Scenario_Preset& preset) {
+    s.name = preset.name;
+    if (preset.entity_count == 0) {
+        s.layout = Scenario_Layout::Default;
+        return;
+    }
+
+    s.layout            = Scenario_Layout::Generated;
+    s.enemy_count       = preset.entity_count / 2;
+    s.barrel_count      = preset.entity_count / 5;
+    s.collectible_count = preset.entity_count / 5;
+    s.bullet_count      = preset.entity_count - s.enemy_count - s.barrel_count - s.collectible_count;
+}
+
+static void scenario_use_custom_counts(Scenario& s) {
+    s.name   = "custom";
+    s.layout = Scenario_Layout::Generated;
+}
+
+static bool parse_u64(const char* str, u64& out) {
+    char* end = nullptr;
+    out = std::strtoull(str, &end, 10);
+    return end != str && *end == '\0';
+}
+
+static bool parse_u32(const char* str, u32& out) {
+    u64 value = 0;
+    if (!parse_u64(str, value) || value > UINT32_MAX) return false;
+    out = (u32)value;
+    return true;
+}
+
+static bool parse_f32(const char* str, f32& out) {
+    char* end = nullptr;
+    out = std::strtof(str, &end);
+    return end != str && *end == '\0';
+}
+
+// every argument of the scenario takes a value
+static constexpr const char* scenario_args[] = {
+    "--scenario", "--seed", "--enemies", "--barrels", "--collectibles", "--bullets", "--armed",
+};
+
+bool scenario_parse_args(Scenario& s, int argc, char** argv) {
+    for (int idx = 1; idx < argc; idx++) {
+        const char* arg = argv[idx];
+        const char* value = (idx + 1 < argc) ? argv[idx + 1] : nullptr;
+
+        bool known = false;
+        for (const char* name : scenario_args) known = known || std::strcmp(arg, name) == 0;
+        if (!known) continue;
+        if (!value) {
+            SDL_Log("Missing the value for argument %s\n", arg);
+            return false;
+        }
+
+        bool ok = true;
+        if (std::strcmp(arg, "--scenario") == 0) {
+            ok = false;
+            for (const auto& preset : presets) {
+                if (std::strcmp(preset.name, value) == 0) {
+                    scenario_apply_preset(s, preset);
+                    ok = true;
+                    break;
+                }
+            }
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            ok = parse_u64(value, s.seed);
+        } else if (std::strcmp(arg, "--enemies") == 0) {
+            ok = parse_u32(value, s.enemy_count);
+            scenario_use_custom_counts(s);
+        } else if (std::strcmp(arg, "--barrels") == 0) {
+            ok = parse_u32(value, s.barrel_count);
+            scenario_use_custom_counts(s);
+        } else if (std::strcmp(arg, "--collectibles") == 0) {
+            ok = parse_u32(value, s.collectible_count);
+            scenario_use_custom_counts(s);
+        } else if (std::strcmp(arg, "--bullets") == 0) {
+            ok = parse_u32(value, s.bullet_count);
+            scenario_use_custom_counts(s);
+        } else if (std::strcmp(arg, "--armed") == 0) {
+            ok = parse_f32(value, s.armed_perc) && s.armed_perc >= 0.0f && s.armed_perc <= 1.0f;
+        }
+
+        if (!ok) {
+            SDL_Log("Invalid value '%s' for argument %s\n", value, arg);
+            return false;
+        }
+        idx++; // skip the consumed value
+    }
+
+    // its own sequence, so that the amount of bullets doesnt change the layout of the rest
+    s.bullet_rng = s.seed ^ 0xb011e75ull;
+    return true;
+}
+
+u32 scenario_entity_count(const Scenario& s) {
+    return s.enemy_count + s.barrel_count + s.collectible_count + s.bullet_count;
+}
+
+static f32 rand_range(u64& state, f32 min, f32 max) {
+    return min + SDL_randf_r(&state) * (max - min);
+}
+
+static Direction rand_dir(u64& state) {
+    return SDL_rand_r(&state, 2) == 0 ? Direction::Left : Direction::Right;
+}
+
+struct Scenario_Area {
+    f32 x_min, x_max;
+    f32 y_min, y_max;
+};
+
+// the walkable band between the top and the bottom borders of the level
+static Scenario_Area scenario_area(const Game& g) {
+    const auto top    = level_info_get_collision_box(g.curr_level_info, Border::Top);
+    const auto bottom = level_info_get_collision_box(g.curr_level_info, Border::Bottom);
+    return {0.0f, g.bg.width, top.y + top.h + 4.0f, bottom.y - 1.0f};
+}
+
+// every random value is drawn in a fixed order from a single state,
+// so the same seed and counts always give the same layout
+static void scenario_spawn_generated(Game& g, const Scenario& s) {
+    u64 state = s.seed;
+
+    const auto [x_min, x_max, y_min, y_max] = scenario_area(g);
+
+    for (u32 idx = 0; idx < s.enemy_count; idx++) {
+        const auto type = enemy_types[SDL_rand_r(&state, std::size(enemy_types))];
+        const auto x    = rand_range(state, x_min, x_max);
+        const auto y    = rand_range(state, y_min, y_max);
+
+        bool has_knife = false;
+        bool has_gun   = false;
+        if (type != Enemy_Type::Boss && SDL_randf_r(&state) < s.armed_perc) {
+            has_knife = SDL_rand_r(&state, 2) == 0;
+            has_gun   = !has_knife;
+        }
+
+        spawn_enemy(g, {
+            .type             = type,
+            .health           = 200.0f,
+            .damage           = 10.0f,
+            .x                = x,
+            .y                = y,
+            .has_knife        = has_knife,
+            .can_spawn_knives = has_knife,
+            .has_gun          = has_gun,
+        });
+    }
+
+    for (u32 idx = 0; idx < s.barrel_count; idx++) {
+        const auto x = rand_range(state, x_min, x_max);
+        const auto y = rand_range(state, y_min, y_max);
+
+        std::optional<Collectible_Type> held_collectible = std::nullopt;
+        const auto roll = SDL_rand_r(&state, std::size(collectible_types) + 1);
+        if (roll < (Sint32)std::size(collectible_types)) held_collectible = collectible_types[roll];
+
+        spawn_barrel(g, {
+            .x                = x,
+            .y                = y,
+            .sprite           = &g.sprite_barrel,
+            .held_collectible = held_collectible,
+        });
+    }
+
+    for (u32 idx = 0; idx < s.collectible_count; idx++) {
+        const auto type = collectible_types[SDL_rand_r(&state, std::size(collectible_types))];
+        const auto x    = rand_range(state, x_min, x_max);
+        const auto y    = rand_range(state, y_min, y_max);
+        const auto dir  = rand_dir(state);
+
+        spawn_collectible(g, {
+            .type     = type,
+            .state    = Collectible_State::Dropped,
+            .position = {x, y},
+            .dir      = dir,
+            .done_by  = Entity_Type::Barrel,
+        });
+    }
+
+}
+
+void scenario_update(Game& g, Scenario& s) {
+    if (s.layout != Scenario_Layout::Generated || s.bullet_count == 0) return;
+
+    // the tracers of the last shots are still flying, only the ones that landed get replaced
+    const u32 target = std::min(s.bullet_count, BULLET_POOL_CAPACITY);
+    const u32 alive  = g.bullets.count + (u32)g.spawns.bullets.size();
+    if (alive >= target) return;
+
+    const auto [x_min, x_max, y_min, y_max] = scenario_area(g);
+    for (u32 idx = alive; idx < target; idx++) {
+        const auto x   = rand_range(s.bullet_rng, x_min, x_max);
+        const auto y   = rand_range(s.bullet_rng, y_min, y_max);
+        const auto dir = rand_dir(s.bullet_rng);
+
+        // harmless, a run keeps shooting for all of its frames and would otherwise kill everything in the first second
+        spawn_bullet(g, {
+            .pos_creator = {x, y},
+            .offsets     = {0.0f, -15.0f},
+            .dir         = dir,
+            .shot_by     = Entity_Type::Player,
+            .harmless    = true,
+        });
+    }
+}
+
+void scenario_spawn(Game& g, const Scenario& s) {
+    switch (s.layout) {
+        case Scenario_Layout::Default: {
+            // the waves of the level file, level_waves_update spawns them
+        } break;
+
+        case Scenario_Layout::Generated: {
+            // only the generated entities, so that the counts of a stress run are exact
+            level_waves_clear(g);
+            scenario_spawn_generated(g, s);
+            SDL_Log("Spawned scenario '%s' (seed %llu) with %u entities\n", s.name, (unsigned long long)s.seed, scenario_entity_count(s));
+        } break;
+    }
+}
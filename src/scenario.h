@@ -0,0 +1,50 @@
+#pragma once
+
+#include "number_types.h"
+
+struct Game;
+
+enum struct Scenario_Layout {
+    // the waves from the level file
+    Default,
+    // entities scattered over the level, generated from the seed and the counts below
+    Generated,
+};
+
+struct Scenario {
+    const char*     name              = "default";
+    Scenario_Layout layout            = Scenario_Layout::Default;
+    u64             seed              = 1;
+    u32             enemy_count       = 0;
+    u32             barrel_count      = 0;
+    u32             collectible_count = 0;
+    u32             bullet_count      = 0; // tracers kept in flight for the whole run, see scenario_update
+    u64             bullet_rng        = 0;
+
+    // fraction of the generated non boss enemies that hold a knife or a gun
+    f32             armed_perc        = 0.3f;
+};
+
+// Recognized arguments:
+//   --scenario <name>    one of the presets (default, stress-10, stress-100, stress-1000, stress-10000)
+//   --seed <n>           seed for the generated layout, same seed gives the same layout
+//   --enemies <n>        overrides the amount of enemies (switches to a generated layout)
+//   --barrels <n>        same for barrels
+//   --collectibles <n>   same for collectibles
+//   --bullets <n>        same for bullets
+//   --armed <0..1>       fraction of generated enemies that are armed
+//
+// Unknown arguments are skipped so that other systems can parse their own.
+//
+// returns false on malformed arguments
+bool scenario_parse_args(Scenario& s, int argc, char** argv);
+
+// Has to be called after all of the sprites are loaded, only records the spawns,
+// they get created by spawn_buffer_apply.
+void scenario_spawn(Game& g, const Scenario& s);
+
+// Once per frame before the update, refires the tracers of the generated layout that landed,
+// so that the bullet pool stays under load for the whole run instead of only the first frames.
+void scenario_update(Game& g, Scenario& s);
+
+u32 scenario_entity_count(const Scenario& s);
@@ -1,3 +1,207 @@
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+#include <SDL3/SDL.h>
+
 #include "settings.h"
 
-Settings settings{};
+static Settings settings_snapshot{};
+const Settings& settings = settings_snapshot;
+Settings settings_pending{};
+
+void settings_publish() {
+    settings_snapshot = settings_pending;
+}
+
+enum struct Settings_Field_Kind {
+    Bool,
+    F32,
+    U64,
+    Color,
+};
+
+struct Settings_Field {
+    const char*         name;
+    Settings_Field_Kind kind;
+    usize               offset;
+    usize               size;
+    f64                 min;
+    f64                 max;
+};
+
+template <typename T>
+static constexpr Settings_Field_Kind settings_field_kind() {
+    if constexpr (std::is_same_v<T, bool>)           return Settings_Field_Kind::Bool;
+    if constexpr (std::is_same_v<T, f32>)            return Settings_Field_Kind::F32;
+    if constexpr (std::is_same_v<T, u64>)            return Settings_Field_Kind::U64;
+    if constexpr (std::is_same_v<T, Settings_Color>) return Settings_Field_Kind::Color;
+}
+
+// in the order of settings.def, the bits of Settings_Overrides::is_set are indices into this
+static constexpr Settings_Field settings_fields[] = {
+#define SETTING(type, name, default_value, min, max) \
+    {#name, settings_field_kind<type>(), offsetof(Settings, name), sizeof(type), (f64)(min), (f64)(max)},
+#include "settings.def"
+#undef SETTING
+};
+static_assert(std::size(settings_fields) == SETTINGS_FIELD_COUNT);
+
+static constexpr bool settings_fields_have_ranges() {
+    for (const auto& field : settings_fields) {
+        if (field.min > field.max) return false;
+    }
+    return true;
+}
+static_assert(settings_fields_have_ranges(), "a setting with min > max in settings.def");
+
+bool settings_parse_args(Settings_Args& a, int argc, char** argv) {
+    for (int idx = 1; idx < argc; idx++) {
+        const char* arg = argv[idx];
+        const char* value = (idx + 1 < argc) ? argv[idx + 1] : nullptr;
+
+        if (std::strcmp(arg, "--settings") == 0) {
+            if (!value) {
+                SDL_Log("Missing the path for argument %s\n", arg);
+                return false;
+            }
+            a.path       = value;
+            a.path_given = true;
+            idx++;
+        }
+    }
+
+    return true;
+}
+
+static bool settings_in_range(const Settings_Field& field, f64 value) {
+    return value >= field.min && value <= field.max;
+}
+
+// the value words of a line, after the name
+static bool settings_parse_value(const Settings_Field& field, char* value, void* dst) {
+    char* end = nullptr;
+    switch (field.kind) {
+        case Settings_Field_Kind::Bool: {
+            const long v = std::strtol(value, &end, 10);
+            if (end == value || (v != 0 && v != 1)) return false;
+            *(bool*)dst = v == 1;
+        } break;
+
+        case Settings_Field_Kind::F32: {
+            *(f32*)dst = std::strtof(value, &end);
+            if (end == value || !settings_in_range(field, *(f32*)dst)) return false;
+        } break;
+
+        case Settings_Field_Kind::U64: {
+            if (value[0] == '-') return false;
+            *(u64*)dst = std::strtoull(value, &end, 10);
+            if (end == value || !settings_in_range(field, (f64)*(u64*)dst)) return false;
+        } break;
+
+        case Settings_Field_Kind::Color: {
+            auto& color = *(Settings_Color*)dst;
+            for (auto& channel : color) {
+                channel = std::strtof(value, &end);
+                if (end == value || !settings_in_range(field, channel)) return false;
+                value = end;
+            }
+        } break;
+    }
+
+    // nothing but spaces after the value
+    while (*end == ' ' || *end == '\t' || *end == '\r') end++;
+    return *end == '\0';
+}
+
+static bool settings_parse_line(Settings_Overrides& out, char* line) {
+    char* comment = std::strchr(line, '#');
+    if (comment) *comment = '\0';
+
+    char* name = line + std::strspn(line, " \t\r");
+    if (*name == '\0') return true;
+    char* value = name + std::strcspn(name, " \t\r");
+    if (*value == '\0') return false;
+    *value++ = '\0';
+
+    for (usize idx = 0; idx < std::size(settings_fields); idx++) {
+        const auto& field = settings_fields[idx];
+        if (std::strcmp(field.name, name) != 0) continue;
+
+        // out of range counts as malformed, the line number in the log is enough to find it
+        if (!settings_parse_value(field, value, (u8*)&out.values + field.offset)) return false;
+        out.is_set.set(idx);
+        return true;
+    }
+    return false;
+}
+
+bool settings_load(Settings_Overrides& out, const char* path) {
+    // null terminated by SDL
+    char* text = (char*)SDL_LoadFile(path, nullptr);
+    if (!text) {
+        SDL_Log("Failed to read settings %s! SDL err: %s\n", path, SDL_GetError());
+        return false;
+    }
+
+    out = {};
+    u32   line_number = 0;
+    char* curr        = text;
+    bool  ok          = true;
+    while (curr && ok) {
+        line_number++;
+        char* next = std::strchr(curr, '\n');
+        if (next) *next++ = '\0';
+
+        ok = settings_parse_line(out, curr);
+        if (!ok) SDL_Log("Malformed line %u in settings %s\n", line_number, path);
+        curr = next;
+    }
+
+    SDL_free(text);
+    return ok;
+}
+
+void settings_apply(Settings& s, const Settings_Overrides& o) {
+    for (usize idx = 0; idx < std::size(settings_fields); idx++) {
+        if (!o.is_set.test(idx)) continue;
+        const auto& field = settings_fields[idx];
+        std::memcpy((u8*)&s + field.offset, (const u8*)&o.values + field.offset, field.size);
+    }
+}
+
+static void settings_write_value(FILE* out, const Settings_Field& field, const void* src) {
+    switch (field.kind) {
+        case Settings_Field_Kind::Bool:  std::fprintf(out, "%d",   *(const bool*)src ? 1 : 0);                    break;
+        case Settings_Field_Kind::F32:   std::fprintf(out, "%.9g", *(const f32*)src);                             break;
+        case Settings_Field_Kind::U64:   std::fprintf(out, "%llu", (unsigned long long)*(const u64*)src);         break;
+        case Settings_Field_Kind::Color: {
+            const auto& color = *(const Settings_Color*)src;
+            std::fprintf(out, "%.9g %.9g %.9g %.9g", color[0], color[1], color[2], color[3]);
+        } break;
+    }
+}
+
+bool settings_save(const Settings& s, const char* path) {
+    FILE* out = std::fopen(path, "w");
+    if (!out) {
+        SDL_Log("Could not open settings '%s' for writing!\n", path);
+        return false;
+    }
+
+    static const Settings defaults{};
+    std::fprintf(out, "# written by the game, the commented out settings have their default value\n");
+    for (const auto& field : settings_fields) {
+        const void* value      = (const u8*)&s + field.offset;
+        const bool  is_default = std::memcmp(value, (const u8*)&defaults + field.offset, field.size) == 0;
+        std::fprintf(out, "%s%s ", is_default ? "# " : "", field.name);
+        settings_write_value(out, field, value);
+        std::fprintf(out, "    # %g..%g\n", field.min, field.max);
+    }
+
+    const bool ok = std::fclose(out) == 0;
+    if (!ok) SDL_Log("Could not write settings '%s'!\n", path);
+    return ok;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <bitset>
 #include "number_types.h"
 
 const int SCREEN_WIDTH  = 100;
@@ -8,66 +9,59 @@ const int SCREEN_HEIGHT = 64;
 const int WINDOW_WIDTH  = 1000;
 const int WINDOW_HEIGHT = 640;
 
-struct Settings {
-    bool show_collision_boxes  = false;
-    bool show_hurtboxes        = false;
-    bool show_hitboxes         = false;
-    bool show_attack_slots     = false;
-    bool show_sprite_debug     = false;
-    bool show_bullet_start     = true;
-    bool dev_mode              = true;
-
-    std::array<f32, 4> colors_collision_box_border = {255,      2,        0,        200};
-    std::array<f32, 4> colors_collision_box_fill   = {255/2.0f, 2/2.0f,   0/2.0f,   200/2.0f};
-
-    std::array<f32, 4> colors_hurtbox_border       = {2,        255,      0,        200};
-    std::array<f32, 4> colors_hurtbox_fill         = {2/2.0f,   255/2.0f, 0/2.0f,   200/2.0f};
-
-    std::array<f32, 4> colors_hitbox_border        = {0,        2,        255,      200};
-    std::array<f32, 4> colors_hitbox_fill          = {0/2.0f,   2/2.0f,   255/2.0f, 200/2.0f};
-
-    std::array<f32, 4> color_text                  = {0,        0,        0,        255};
+using Settings_Color = std::array<f32, 4>;
 
-    f32 ground_level                         = 0.0f;
-    f32 font_size_default                    = 9.0f;
-    f32 fps_max                              = 144.0f;
-    f32 time_scale                           = 1.0f;
-
-    f32 gravity                              = 0.00038f;
-    f32 jump_velocity                        = -0.15f;
-
-    f32 player_max_health                    = 200.0f;
-    u64 player_combo_timeout_ms              = 1000;
-    f32 player_knockdown_velocity            = 0.1f;
-    f32 player_knockback_velocity            = 0.04f;
-    f32 player_flying_back_velocity          = 0.1f;
-    u64 default_bullet_count_on_pick_up      = 3;
+struct Settings {
+#define SETTING(type, name, default_value, min, max) type name = default_value;
+#include "settings.def"
+#undef SETTING
+};
 
-    f32 barrel_jump_velocity                 = -0.10f;
-    f32 barrel_knockback_velocity            = 0.05f;
+// amount of fields in Settings
+const u32 SETTINGS_FIELD_COUNT = 0
+#define SETTING(...) + 1
+#include "settings.def"
+#undef SETTING
+    ;
 
-    f32 enemy_boss_speed                     = 0.012f;
-    f32 enemy_boss_flying_kick_speed         = 0.07f;
-    f32 enemy_thug_speed                     = 0.015f;
-    f32 enemy_goon_speed                     = 0.02f;
-    f32 enemy_punk_speed                     = 0.02f;
-    f32 enemy_knockback_velocity             = 0.04f;
-    f32 enemy_knockdown_velocity             = 0.1f;
-    f32 enemy_flying_back_velocity           = 0.1f;
+// The settings of the current frame. Only settings_publish changes them, and only between two frames,
+// so everything that runs during a frame (on any thread) sees the same values.
+extern const Settings& settings;
+// Where every change goes (the debug keys, the settings file, hot reloading) until the next settings_publish.
+extern Settings settings_pending;
 
-    f32 enemy_boss_distance_to_player_target = 20.0f;
-    f32 enemy_friction                       = 0.003f;
-    f32 enemy_flying_back_dmg_collateral_dmg = 20.0f;
-    u64 enemy_attack_timeout_ms              = 1000;
+void settings_publish();
 
-    f32 collectible_drop_jump_velocity       = -0.15f;
-    f32 collectible_drop_sideways_velocity   = 0.02f;
-    f32 collectible_velocity                 = 0.13f;
+// Optional, for tuning without a rebuild. One "name value" per line with the names of settings.def,
+// colors take 4 values, bools are 0 or 1, # starts a comment. The fields it doesnt mention keep their value.
+const char* const SETTINGS_PATH = "settings.cfg";
 
-    f32 knife_damage                         = 20.0f;
-    f32 knife_throwing_threshold             = 4.0f;
+struct Settings_Args {
+    const char* path       = SETTINGS_PATH;
+    bool        path_given = false;
+};
 
-    f32 gun_damage                           = 40.0f;
+// Recognized arguments:
+//   --settings <path>   another settings file, benchmarks only read one when it is given like this
+//
+// Unknown arguments are skipped so that other systems can parse their own.
+//
+// returns false on malformed arguments
+bool settings_parse_args(Settings_Args& a, int argc, char** argv);
+
+// the values of a settings file and which of the fields it set
+struct Settings_Overrides {
+    Settings                          values;
+    std::bitset<SETTINGS_FIELD_COUNT> is_set;
 };
 
-extern Settings settings;
+// Only allocates through SDL, so it can be called from any thread.
+//
+// returns false if the file cant be read, has a malformed line or a value out of its range
+bool settings_load(Settings_Overrides& out, const char* path);
+void settings_apply(Settings& s, const Settings_Overrides& o);
+// Every field with its range, the ones that still have their default value are commented out
+// so that changing a default in settings.def still has an effect.
+//
+// returns false on error
+bool settings_save(const Settings& s, const char* path);
@@ -0,0 +1,112 @@
+#include <cassert>
+
+#include "sheet_cache.h"
+#include "game.h"
+#include "utils.h"
+#include "palette.h"
+
+struct Sheet_Def {
+    const char* path;
+    const char* palette_path = nullptr; // swapped when loading, the colors of the sheet itself without one
+};
+
+static constexpr Sheet_Def sheet_defs[] = {
+    {"assets/art/characters/enemy_goon.png"},
+    {"assets/art/characters/enemy_punk.png"},
+    {"assets/art/characters/enemy_thug.png"},
+    {"assets/art/characters/enemy_boss.png"},
+    {"assets/art/characters/enemy_goon.png", "assets/art/palettes/enemy_goon_alt.palette"},
+    {"assets/art/characters/enemy_punk.png", "assets/art/palettes/enemy_punk_alt.palette"},
+    {"assets/art/characters/enemy_thug.png", "assets/art/palettes/enemy_thug_alt.palette"},
+    {"assets/art/characters/enemy_knife.png"},
+    {"assets/art/characters/enemy_gun.png"},
+    {"assets/art/characters/player_knife.png"},
+    {"assets/art/characters/player_gun.png"},
+};
+static_assert(std::size(sheet_defs) == (usize)Sheet::COUNT);
+
+Sprite& sheet_sprite(Game& g, Sheet s) {
+    switch (s) {
+        case Sheet::Enemy_Goon:   return g.sprite_enemy_goon;
+        case Sheet::Enemy_Punk:   return g.sprite_enemy_punk;
+        case Sheet::Enemy_Thug:   return g.sprite_enemy_thug;
+        case Sheet::Enemy_Boss:   return g.sprite_enemy_boss;
+        case Sheet::Enemy_Goon_Alt: return g.sprite_enemy_goon_alt;
+        case Sheet::Enemy_Punk_Alt: return g.sprite_enemy_punk_alt;
+        case Sheet::Enemy_Thug_Alt: return g.sprite_enemy_thug_alt;
+        case Sheet::Enemy_Knife:  return g.sprite_knife_enemy;
+        case Sheet::Enemy_Gun:    return g.sprite_gun_enemy;
+        case Sheet::Player_Knife: return g.sprite_knife_player;
+        case Sheet::Player_Gun:   return g.sprite_gun_player;
+        default:                  unreachable("not a sheet");
+    }
+}
+
+Sheet sheet_of_enemy(Enemy_Type type, bool alt_colors) {
+    switch (type) {
+        case Enemy_Type::Goon: return alt_colors ? Sheet::Enemy_Goon_Alt : Sheet::Enemy_Goon;
+        case Enemy_Type::Punk: return alt_colors ? Sheet::Enemy_Punk_Alt : Sheet::Enemy_Punk;
+        case Enemy_Type::Thug: return alt_colors ? Sheet::Enemy_Thug_Alt : Sheet::Enemy_Thug;
+        case Enemy_Type::Boss: return Sheet::Enemy_Boss;
+    }
+    unreachable("not an enemy type");
+}
+
+Sheet sheet_of_weapon(Entity_Type holder, Collectible_Type weapon) {
+    const bool enemy = holder == Entity_Type::Enemy;
+    switch (weapon) {
+        case Collectible_Type::Knife: return enemy ? Sheet::Enemy_Knife : Sheet::Player_Knife;
+        case Collectible_Type::Gun:   return enemy ? Sheet::Enemy_Gun   : Sheet::Player_Gun;
+        case Collectible_Type::Food:  break;
+    }
+    unreachable("not a weapon");
+}
+
+void sheet_acquire(Game& g, Sheet s) {
+    g.sheets.ref_counts[(usize)s]++;
+}
+
+void sheet_release(Game& g, Sheet s) {
+    assert(g.sheets.ref_counts[(usize)s] > 0);
+    g.sheets.ref_counts[(usize)s]--;
+}
+
+bool sheet_require(Game& g, Sheet s) {
+    auto& sprite = sheet_sprite(g, s);
+    if (sprite.img.img) return true;
+
+    const auto& def = sheet_defs[(usize)s];
+    bool ok;
+    if (def.palette_path) {
+        Palette palette;
+        ok = palette_load(palette, def.palette_path) && sprite_load_with_palette(sprite, g.renderer, def.path, palette);
+    } else {
+        ok = sprite_load(sprite, g.renderer, def.path);
+    }
+    if (!ok) {
+        SDL_Log("Failed to load sheet %s!\n", def.path);
+        return false;
+    }
+    g.sheets.loads++;
+    g.sheets.resident++;
+    return true;
+}
+
+void sheet_cache_evict_unused(Game& g) {
+    for (usize idx = 0; idx < (usize)Sheet::COUNT; idx++) {
+        if (g.sheets.ref_counts[idx] > 0) continue;
+
+        auto& sprite = sheet_sprite(g, (Sheet)idx);
+        if (!sprite.img.img) continue;
+        SDL_DestroyTexture(sprite.img.img);
+        sprite.img = {};
+        g.sheets.resident--;
+    }
+}
+
+void sheet_cache_watch_for_reload(Game& g) {
+    for (usize idx = 0; idx < (usize)Sheet::COUNT; idx++) {
+        const auto& def = sheet_defs[idx];
+        hot_reload_watch_img(g.hot_reload, sheet_sprite(g, (Sheet)idx).img, def.path, def.palette_path);
+    }
+}
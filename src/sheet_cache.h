@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+
+#include "number_types.h"
+#include "sprite.h"
+#include "entities/entity.h"
+
+struct Game;
+
+// The sheets that not every level needs, everything else is loaded once in init.
+enum struct Sheet : u32 {
+    Enemy_Goon,
+    Enemy_Punk,
+    Enemy_Thug,
+    Enemy_Boss,
+    // palette swaps of the sheets above, on disk and in the pack they only add a palette file instead of
+    // another sheet, once loaded every one is a full texture of its own like its base sheet
+    Enemy_Goon_Alt,
+    Enemy_Punk_Alt,
+    Enemy_Thug_Alt,
+    Enemy_Knife,
+    Enemy_Gun,
+    Player_Knife,
+    Player_Gun,
+    COUNT // KEEP THIS LAST
+};
+
+// How many things (pending spawns of the level, live entities, the player) still need every sheet.
+// Loading is lazy and a sheet that drops to 0 stays resident, only sheet_cache_evict_unused frees it,
+// so an enemy dying right before the next one of its type spawns doesnt reload the texture.
+struct Sheet_Cache {
+    std::array<u32, (usize)Sheet::COUNT> ref_counts;
+    u32                                  loads;     // since the start, for the debug menu
+    u32                                  resident;
+};
+
+// the sprite in Game that the sheet is loaded into
+Sprite& sheet_sprite(Game& g, Sheet s);
+// the boss has no palette swapped variant
+Sheet sheet_of_enemy(Enemy_Type type, bool alt_colors);
+// the knife or gun drawn over a holder of that type
+Sheet sheet_of_weapon(Entity_Type holder, Collectible_Type weapon);
+
+void sheet_acquire(Game& g, Sheet s);
+void sheet_release(Game& g, Sheet s);
+// Loads the texture if it isnt resident yet, the sprite metadata is already set in Game.
+//
+// returns false on error
+bool sheet_require(Game& g, Sheet s);
+// frees the textures of every sheet that nothing references anymore
+void sheet_cache_evict_unused(Game& g);
+// every sheet, resident or not, an evicted one simply loads the new file the next time
+void sheet_cache_watch_for_reload(Game& g);
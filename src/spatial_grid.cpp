@@ -0,0 +1,62 @@
+#include <cmath>
+
+#include "spatial_grid.h"
+#include "entities/entity.h"
+
+static const u32 SPATIAL_GRID_NOT_INSERTED = UINT32_MAX;
+
+static u32 spatial_grid_cell(f32 pos, f32 origin, u32 count) {
+    const f32 cell = std::floor((pos - origin) / SPATIAL_GRID_CELL_SIZE);
+    if (cell < 0.0f) return 0;
+    return std::min((u32)cell, count - 1);
+}
+
+u32 spatial_grid_cell_x(const Spatial_Grid& grid, f32 x) {
+    return spatial_grid_cell(x, grid.origin_x, grid.cols);
+}
+
+u32 spatial_grid_cell_y(const Spatial_Grid& grid, f32 y) {
+    return spatial_grid_cell(y, grid.origin_y, grid.rows);
+}
+
+void spatial_grid_build(Spatial_Grid& grid, std::span<const Entity> entities, SDL_FRect bounds) {
+    grid.origin_x = bounds.x;
+    grid.origin_y = bounds.y;
+    grid.cols     = std::max(1u, (u32)std::ceil(bounds.w / SPATIAL_GRID_CELL_SIZE));
+    grid.rows     = std::max(1u, (u32)std::ceil(bounds.h / SPATIAL_GRID_CELL_SIZE));
+
+    // a counting sort of the entities by cell, the arrays keep their capacity between frames
+    const u32 cell_count = grid.cols * grid.rows;
+    grid.cell_start.assign(cell_count + 1, 0);
+    grid.item_cell.resize(entities.size());
+
+    u32 inserted = 0;
+    for (u32 idx = 0; idx < entities.size(); idx++) {
+        const auto& e = entities[idx];
+        if (e.sleeping) {
+            grid.item_cell[idx] = SPATIAL_GRID_NOT_INSERTED;
+            continue;
+        }
+
+        const u32 cell = spatial_grid_cell_y(grid, e.y) * grid.cols + spatial_grid_cell_x(grid, e.x);
+        grid.item_cell[idx] = cell;
+        grid.cell_start[cell + 1]++;
+        inserted++;
+    }
+
+    for (u32 cell = 0; cell < cell_count; cell++) {
+        grid.cell_start[cell + 1] += grid.cell_start[cell];
+    }
+
+    // cell_start gets used as the write cursor and is shifted back afterwards
+    grid.items.resize(inserted);
+    for (u32 idx = 0; idx < entities.size(); idx++) {
+        const u32 cell = grid.item_cell[idx];
+        if (cell == SPATIAL_GRID_NOT_INSERTED) continue;
+        grid.items[grid.cell_start[cell]++] = idx;
+    }
+    for (u32 cell = cell_count; cell > 0; cell--) {
+        grid.cell_start[cell] = grid.cell_start[cell - 1];
+    }
+    grid.cell_start[0] = 0;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+#include "number_types.h"
+
+struct Entity;
+
+const f32 SPATIAL_GRID_CELL_SIZE = 16.0f;
+// Queries for boxes of other entities grow the area by this much. The boxes reach up to 23 from the position
+// the grid buckets by (hitboxes above the feet, the thrown knife to the side), plus a few pixels of movement.
+const f32 SPATIAL_GRID_BOX_MARGIN = 2*SPATIAL_GRID_CELL_SIZE;
+
+// Indices of the awake entities bucketed by a uniform grid over the level, rebuilt at the start of the update.
+// The indices stay valid through the entity updates, spawns and despawns only happen after them, and
+// spawn_buffer_apply builds it again before the bullets of the frame fire.
+// Entities move during the frame, so queries give candidates and the caller checks the actual positions.
+struct Spatial_Grid {
+    f32 origin_x = 0.0f;
+    f32 origin_y = 0.0f;
+    u32 cols     = 0;
+    u32 rows     = 0;
+    // items of cell i are items[cell_start[i]] .. items[cell_start[i + 1]]
+    std::vector<u32> cell_start;
+    std::vector<u32> items;
+    std::vector<u32> item_cell; // cell of every entity, only used while building
+};
+
+// Positions outside of bounds go into the border cells.
+void spatial_grid_build(Spatial_Grid& grid, std::span<const Entity> entities, SDL_FRect bounds);
+
+u32 spatial_grid_cell_x(const Spatial_Grid& grid, f32 x);
+u32 spatial_grid_cell_y(const Spatial_Grid& grid, f32 y);
+
+// Calls fn(idx_entity) for every entity in the cells that area touches.
+template<typename Fn>
+void spatial_grid_query(const Spatial_Grid& grid, SDL_FRect area, Fn&& fn) {
+    if (grid.cols == 0 || grid.rows == 0) return;
+
+    const u32 col_first = spatial_grid_cell_x(grid, area.x);
+    const u32 col_last  = spatial_grid_cell_x(grid, area.x + area.w);
+    const u32 row_first = spatial_grid_cell_y(grid, area.y);
+    const u32 row_last  = spatial_grid_cell_y(grid, area.y + area.h);
+
+    for (u32 row = row_first; row <= row_last; row++) {
+        for (u32 col = col_first; col <= col_last; col++) {
+            const u32 cell = row * grid.cols + col;
+            for (u32 idx = grid.cell_start[cell]; idx < grid.cell_start[cell + 1]; idx++) {
+                fn(grid.items[idx]);
+            }
+        }
+    }
+}
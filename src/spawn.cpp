@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <cassert>
+
+#include "spawn.h"
+#include "game.h"
+
+#include "entities/player.h"
+#include "entities/enemy.h"
+#include "entities/barrel.h"
+#include "entities/collectible.h"
+#include "entities/bullet.h"
+
+void spawn_buffer_init(Spawn_Buffer& b) {
+    b.players.reserve(1);
+    b.enemies.reserve(SPAWN_BUFFER_RESERVE);
+    b.barrels.reserve(SPAWN_BUFFER_RESERVE);
+    b.collectibles.reserve(SPAWN_BUFFER_RESERVE);
+    b.bullets.reserve(SPAWN_BUFFER_RESERVE);
+    b.despawns.reserve(SPAWN_BUFFER_RESERVE);
+}
+
+void spawn_player(Game& g, Player_Init_Opts opts) {
+    g.spawns.players.push_back(opts);
+}
+
+void spawn_enemy(Game& g, Enemy_Init_Opts opts) {
+    g.spawns.enemies.push_back(opts);
+}
+
+void spawn_barrel(Game& g, Barrel_Init_Opts opts) {
+    g.spawns.barrels.push_back(opts);
+}
+
+void spawn_collectible(Game& g, Collectible_Init_Opts opts) {
+    g.spawns.collectibles.push_back(opts);
+}
+
+void spawn_bullet(Game& g, Bullet_Init_Opts opts) {
+    g.spawns.bullets.push_back(opts);
+}
+
+void despawn(Game& g, u32 idx_entity) {
+    assert(idx_entity < g.entities.size());
+    g.spawns.despawns.push_back(idx_entity);
+}
+
+static void spawn_buffer_apply_despawns(Game& g) {
+    auto& despawns = g.spawns.despawns;
+    if (despawns.empty()) return;
+
+    std::sort(despawns.begin(), despawns.end());
+    despawns.erase(std::unique(despawns.begin(), despawns.end()), despawns.end());
+
+    // a single pass moving the survivors down instead of an erase (and a shift of everything after it) per despawn,
+    // keeps the order of the entities
+    usize idx_despawn = 0;
+    u32   idx_write   = 0;
+    for (u32 idx = 0; idx < g.entities.size(); idx++) {
+        if (idx_despawn < despawns.size() && despawns[idx_despawn] == idx) {
+            auto& e = g.entities[idx];
+            animation_release(e.anim);
+            if (e.type == Entity_Type::Enemy) {
+                sheet_release(g, sheet_of_enemy(e.extra_enemy.type, e.extra_enemy.alt_colors));
+                if (e.extra_enemy.has_knife) entity_weapon_lost(e, g, Collectible_Type::Knife);
+                if (e.extra_enemy.has_gun)   entity_weapon_lost(e, g, Collectible_Type::Gun);
+            }
+            idx_despawn++;
+            continue;
+        }
+
+        if (idx == g.idx_player) g.idx_player = idx_write;
+        if (idx != idx_write) g.entities[idx_write] = g.entities[idx];
+        idx_write++;
+    }
+    g.entities.erase(g.entities.begin() + idx_write, g.entities.end());
+
+    despawns.clear();
+}
+
+void spawn_buffer_apply(Game& g) {
+    auto& b = g.spawns;
+    const bool despawned = !b.despawns.empty();
+    spawn_buffer_apply_despawns(g);
+
+    const usize count = b.players.size() + b.enemies.size() + b.barrels.size() + b.collectibles.size();
+    // one reallocation at most
+    if (count > 0) g.entities.reserve(g.entities.size() + count);
+
+    // by type, not in the order the spawns of different types were recorded
+    for (const auto& opts : b.players) {
+        g.entities.push_back(player_init(g, opts));
+        g.idx_player = g.entities.size() - 1;
+    }
+    for (const auto& opts : b.enemies)      g.entities.push_back(enemy_init(g, opts));
+    for (const auto& opts : b.barrels)      g.entities.push_back(barrel_init(g, opts));
+    for (const auto& opts : b.collectibles) g.entities.push_back(collectible_init(g, opts));
+    // after the rest, so that the bullets can already hit what was spawned this frame,
+    // the grid they look up their targets in has the indices from before the changes
+    if (!b.bullets.empty() && (despawned || count > 0)) game_build_spatial_grid(g);
+    for (const auto& opts : b.bullets)      bullet_fire(g.bullets, opts, g);
+
+    b.players.clear();
+    b.enemies.clear();
+    b.barrels.clear();
+    b.collectibles.clear();
+    b.bullets.clear();
+}
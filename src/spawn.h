@@ -0,0 +1,87 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "number_types.h"
+#include "settings.h"
+#include "vec2.h"
+#include "sprite.h"
+#include "entities/entity.h"
+
+struct Game;
+
+struct Player_Init_Opts {
+    const Sprite* sprite;
+};
+
+struct Enemy_Init_Opts {
+    Enemy_Type type;
+    f32 health;
+    f32 damage;
+    f32 x;
+    f32 y;
+    bool has_knife;
+    bool can_spawn_knives;
+    bool has_gun;
+    bool alt_colors = false;
+};
+
+struct Barrel_Init_Opts {
+    f32 x;
+    f32 y;
+    f32 health = 20;
+    const Sprite* sprite;
+    std::optional<Collectible_Type> held_collectible = std::nullopt;
+};
+
+struct Collectible_Init_Opts {
+    Collectible_Type  type;
+    Collectible_State state;
+    Vec2<f32>         position;
+    Direction         dir;
+    Entity_Type       done_by;
+    bool              instantly_disappear = false;
+};
+
+struct Bullet_Init_Opts {
+    Vec2<f32>   pos_creator;
+    Vec2<f32>   offsets;
+    Direction   dir;
+    Entity_Type shot_by;
+    f32         length    = SCREEN_WIDTH;
+    f32         thickness = 0.6f;
+    // still raycast and drawn but deals no damage, for load in the stress scenarios
+    bool        harmless  = false;
+};
+
+// commands of a single type that fit in the buffer before it has to grow
+const usize SPAWN_BUFFER_RESERVE = 64;
+
+// Every spawn and despawn requested during a frame, nothing gets added to or removed from
+// g.entities directly, so references into it stay valid while it is being iterated.
+// Each type of command has its own array, they keep their capacity after being applied,
+// so after the first few frames recording commands doesnt allocate.
+struct Spawn_Buffer {
+    std::vector<Player_Init_Opts>      players;
+    std::vector<Enemy_Init_Opts>       enemies;
+    std::vector<Barrel_Init_Opts>      barrels;
+    std::vector<Collectible_Init_Opts> collectibles;
+    std::vector<Bullet_Init_Opts>      bullets;
+    // indices into g.entities, only valid until the buffer gets applied
+    std::vector<u32>                   despawns;
+};
+
+void spawn_buffer_init(Spawn_Buffer& b);
+
+void spawn_player(Game& g, Player_Init_Opts opts);
+void spawn_enemy(Game& g, Enemy_Init_Opts opts);
+void spawn_barrel(Game& g, Barrel_Init_Opts opts);
+void spawn_collectible(Game& g, Collectible_Init_Opts opts);
+void spawn_bullet(Game& g, Bullet_Init_Opts opts);
+void despawn(Game& g, u32 idx_entity);
+
+// Removes the despawned entities and then creates the spawned ones grouped by type: players, enemies,
+// barrels, collectibles and bullets last. Only spawns of the same type keep the order they were recorded in.
+// Has to be called at a point where nothing holds a reference into g.entities.
+void spawn_buffer_apply(Game& g);
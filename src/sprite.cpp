@@ -1,10 +1,27 @@
 #include <SDL3_image/SDL_image.h>
 #include <SDL3/SDL.h>
 #include "sprite.h"
+#include "perf.h"
+#include "asset_pack.h"
 #include <cassert>
 
-bool img_load(Img& i, SDL_Renderer* r, const char* path) {
-    i.img = IMG_LoadTexture(r, path);
+// the pixels are already decoded, they get uploaded straight from the mapped pack
+static SDL_Texture* img_create_from_pack(SDL_Renderer* r, const Asset_Pack_Entry& entry) {
+    SDL_Texture* texture = SDL_CreateTexture(r, ASSET_PACK_PIXEL_FORMAT, SDL_TEXTUREACCESS_STATIC, entry.width, entry.height);
+    if (!texture) return nullptr;
+
+    const auto pixels = asset_pack_bytes(asset_pack, entry);
+    bool ok = SDL_UpdateTexture(texture, nullptr, pixels.data(), entry.width * 4)
+        && SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    if (!ok) {
+        SDL_DestroyTexture(texture);
+        return nullptr;
+    }
+    return texture;
+}
+
+// the size and the scaling, the same for every way of getting the texture
+static bool img_init_texture(Img& i) {
     if (i.img == nullptr) {
         SDL_Log("Could not load img! SDL err: %s\n", SDL_GetError());
         return false;
@@ -25,6 +42,26 @@ bool img_load(Img& i, SDL_Renderer* r, const char* path) {
     return true;
 }
 
+bool img_load(Img& i, SDL_Renderer* r, const char* path) {
+    const auto* entry = asset_pack_find(asset_pack, path);
+    if (entry && entry->kind == Asset_Kind::Pixels) {
+        i.img = img_create_from_pack(r, *entry);
+    } else {
+        i.img = IMG_LoadTexture(r, path);
+    }
+    return img_init_texture(i);
+}
+
+bool img_load_from_surface(Img& i, SDL_Renderer* r, SDL_Surface* surface) {
+    i.img = SDL_CreateTextureFromSurface(r, surface);
+    return img_init_texture(i);
+}
+
+bool img_is_in_asset_pack(const char* path) {
+    const auto* entry = asset_pack_find(asset_pack, path);
+    return entry && entry->kind == Asset_Kind::Pixels;
+}
+
 bool sprite_load(Sprite& s, SDL_Renderer* r, const char* path) {
     assert(s.max_frames_in_row_count   > 0);
     assert(s.frames_in_each_row.size() > 0);
@@ -67,6 +104,7 @@ bool sprite_draw_at_dst(const Sprite& s, SDL_Renderer* r, Sprite_Draw_Opts opts)
     }
     ok = SDL_RenderTextureRotated(r, s.img.img, &src, &dst, opts.rotation_deg, center_of_rot, opts.flip);
     if (!ok) SDL_Log("Failed to draw sprite! SDL err: %s\n", SDL_GetError());
+    perf_count_draw_call(s.img.img);
     ok = SDL_SetTextureAlphaModFloat(s.img.img, 1.0f);
     if (!ok) SDL_Log("Failed to change opacity for drawn sprite! SDL err: %s\n", SDL_GetError());
 
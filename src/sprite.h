@@ -12,9 +12,14 @@ struct Img {
 };
 
 // Has to be called after initializing the renderer.
+// Takes the decoded pixels from the asset pack if it has the path, otherwise decodes the file.
 //
 // returns false on error
 bool img_load(Img& i, SDL_Renderer* r, const char* path);
+// for pixels that were decoded somewhere else, the surface stays owned by the caller
+bool img_load_from_surface(Img& i, SDL_Renderer* r, SDL_Surface* surface);
+// whether img_load would take the path from the asset pack instead of decoding it
+bool img_is_in_asset_pack(const char* path);
 
 struct Sprite {
     Img                  img;
@@ -0,0 +1,44 @@
+#include <cmath>
+
+#include "steering.h"
+#include "game.h"
+
+Vec2<f32> steering_arrive(Vec2<f32> pos, Vec2<f32> target, f32 max_speed, f32 arrive_radius) {
+    auto to_target = target - pos;
+    const f32 distance = to_target.len();
+    if (distance <= 0.0f) return {0.0f, 0.0f};
+
+    const f32 speed = distance < arrive_radius ? max_speed * distance / arrive_radius : max_speed;
+    return to_target * (speed / distance);
+}
+
+Vec2<f32> steering_separation(const Entity& e, const Game& g, f32 radius, f32 max_speed) {
+    const SDL_FRect area = {e.x - radius, e.y - radius, 2*radius, 2*radius};
+    Vec2<f32> push = {0.0f, 0.0f};
+
+    spatial_grid_query(g.grid, area, [&](u32 idx) {
+        const auto& other = g.entities[idx];
+        if (other.handle == e.handle) return;
+        if (other.type != Entity_Type::Enemy && other.type != Entity_Type::Player) return;
+
+        Vec2<f32> away = {e.x - other.x, e.y - other.y};
+        const f32 distance = away.len();
+        if (distance >= radius) return;
+
+        if (distance <= 0.0f) {
+            // exactly on top of each other, the handles decide who goes which way
+            away = {e.handle.id < other.handle.id ? -1.0f : 1.0f, 0.0f};
+        } else {
+            away = away * (1.0f / distance);
+        }
+        push += away * (1.0f - distance / radius);
+    });
+
+    return steering_clamp(push * max_speed, max_speed);
+}
+
+Vec2<f32> steering_clamp(Vec2<f32> v, f32 max_len) {
+    const f32 len = v.len();
+    if (len <= max_len || len <= 0.0f) return v;
+    return v * (max_len / len);
+}
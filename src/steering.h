@@ -0,0 +1,16 @@
+#pragma once
+
+#include "number_types.h"
+#include "vec2.h"
+
+struct Game;
+struct Entity;
+
+// Velocity towards target at max_speed, slowing down linearly inside of arrive_radius.
+Vec2<f32> steering_arrive(Vec2<f32> pos, Vec2<f32> target, f32 max_speed, f32 arrive_radius);
+
+// Push away from the awake enemies and the player within radius, stronger the closer they are,
+// at most max_speed. Neighbours come from g.grid, so it only looks at the nearby cells.
+Vec2<f32> steering_separation(const Entity& e, const Game& g, f32 radius, f32 max_speed);
+
+Vec2<f32> steering_clamp(Vec2<f32> v, f32 max_len);
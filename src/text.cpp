@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <cassert>
+
+#include "text.h"
+#include "perf.h"
+
+static const f32 ATLAS_MAX_ROW_WIDTH = 256.0f;
+static const f32 ATLAS_PADDING       = 1.0f; // keeps neighbouring glyphs from bleeding into each other
+
+bool text_atlas_init(Font_Atlas& a, SDL_Renderer* r, TTF_Font* font) {
+    assert(font != nullptr);
+
+    std::array<SDL_Surface*, TEXT_GLYPH_COUNT> surfaces = {};
+    const SDL_Color white = {255, 255, 255, 255};
+
+    // rasterize every glyph and lay them out in rows
+    f32 x = 0.0f;
+    f32 y = 0.0f;
+    f32 row_height = 0.0f;
+    a.width = 0.0f;
+    for (u32 idx = 0; idx < TEXT_GLYPH_COUNT; idx++) {
+        const u32 ch = TEXT_GLYPH_FIRST + idx;
+        auto& glyph = a.glyphs[idx];
+
+        int advance = 0;
+        if (!TTF_GetGlyphMetrics(font, ch, nullptr, nullptr, nullptr, nullptr, &advance)) {
+            advance = 0;
+        }
+        glyph.advance = advance;
+        glyph.src = {};
+
+        // whitespace doesnt get rasterized by every font, it only needs the advance anyway
+        surfaces[idx] = TTF_RenderGlyph_Blended(font, ch, white);
+        if (!surfaces[idx]) continue;
+
+        const f32 w = surfaces[idx]->w;
+        const f32 h = surfaces[idx]->h;
+        if (x + w > ATLAS_MAX_ROW_WIDTH) {
+            x = 0.0f;
+            y += row_height + ATLAS_PADDING;
+            row_height = 0.0f;
+        }
+
+        glyph.src = {x, y, w, h};
+        x += w + ATLAS_PADDING;
+        row_height = std::max(row_height, h);
+        a.width = std::max(a.width, x);
+    }
+    a.height = y + row_height;
+    a.line_height = TTF_GetFontHeight(font);
+
+    bool ok = true;
+    SDL_Surface* atlas = SDL_CreateSurface(std::max(1.0f, a.width), std::max(1.0f, a.height), SDL_PIXELFORMAT_RGBA32);
+    if (!atlas) {
+        SDL_Log("Could not create font atlas surface! SDL err: %s\n", SDL_GetError());
+        ok = false;
+    }
+
+    for (u32 idx = 0; idx < TEXT_GLYPH_COUNT; idx++) {
+        SDL_Surface* surface = surfaces[idx];
+        if (!surface) continue;
+
+        if (ok) {
+            const auto& src = a.glyphs[idx].src;
+            const SDL_Rect dst = {(int)src.x, (int)src.y, (int)src.w, (int)src.h};
+            // copy the alpha as is instead of blending it onto the empty atlas
+            SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+            if (!SDL_BlitSurface(surface, nullptr, atlas, &dst)) {
+                SDL_Log("Could not copy glyph into the font atlas! SDL err: %s\n", SDL_GetError());
+                ok = false;
+            }
+        }
+        SDL_DestroySurface(surface);
+    }
+
+    if (!ok) {
+        if (atlas) SDL_DestroySurface(atlas);
+        return false;
+    }
+
+    a.texture = SDL_CreateTextureFromSurface(r, atlas);
+    SDL_DestroySurface(atlas);
+    if (!a.texture) {
+        SDL_Log("Could not create font atlas texture! SDL err: %s\n", SDL_GetError());
+        return false;
+    }
+
+    ok = SDL_SetTextureBlendMode(a.texture, SDL_BLENDMODE_BLEND);
+    if (!ok) {
+        SDL_Log("Could not set font atlas blend mode! SDL err: %s\n", SDL_GetError());
+        return false;
+    }
+
+    return true;
+}
+
+static const Glyph& text_get_glyph(const Font_Atlas& a, char c) {
+    u32 ch = (unsigned char)c;
+    if (ch < TEXT_GLYPH_FIRST || ch > TEXT_GLYPH_LAST) ch = '?';
+    return a.glyphs[ch - TEXT_GLYPH_FIRST];
+}
+
+void text_batch_clear(Text_Batch& b) {
+    // keeps the capacity, so rebuilding a batch of the same size doesnt allocate
+    b.vertices.clear();
+    b.indices.clear();
+}
+
+f32 text_batch_add(Text_Batch& b, std::string_view text, Text_Opts opts) {
+    assert(b.atlas != nullptr);
+    const auto& a = *b.atlas;
+
+    b.vertices.reserve(b.vertices.size() + 4 * text.size());
+    b.indices.reserve(b.indices.size() + 6 * text.size());
+
+    f32 x = opts.x;
+    for (char c : text) {
+        const auto& glyph = text_get_glyph(a, c);
+
+        if (glyph.src.w > 0.0f) {
+            const f32 x1 = x;
+            const f32 y1 = opts.y;
+            const f32 x2 = x + glyph.src.w * opts.scale;
+            const f32 y2 = opts.y + glyph.src.h * opts.scale;
+
+            const f32 u1 = glyph.src.x / a.width;
+            const f32 v1 = glyph.src.y / a.height;
+            const f32 u2 = (glyph.src.x + glyph.src.w) / a.width;
+            const f32 v2 = (glyph.src.y + glyph.src.h) / a.height;
+
+            const int first = (int)b.vertices.size();
+            b.vertices.push_back({{x1, y1}, opts.color, {u1, v1}});
+            b.vertices.push_back({{x2, y1}, opts.color, {u2, v1}});
+            b.vertices.push_back({{x1, y2}, opts.color, {u1, v2}});
+            b.vertices.push_back({{x2, y2}, opts.color, {u2, v2}});
+
+            const int quad[6] = {0, 1, 2, 1, 2, 3};
+            for (int idx : quad) b.indices.push_back(first + idx);
+        }
+
+        x += glyph.advance * opts.scale;
+    }
+
+    return x - opts.x;
+}
+
+void text_batch_draw(const Text_Batch& b, SDL_Renderer* r) {
+    if (b.indices.empty()) return;
+    assert(b.atlas != nullptr);
+
+    bool ok = SDL_RenderGeometry(r, b.atlas->texture, b.vertices.data(), b.vertices.size(), b.indices.data(), b.indices.size());
+    if (!ok) SDL_Log("Failed to draw text! SDL err: %s\n", SDL_GetError());
+    perf_count_draw_call(b.atlas->texture);
+}
+
+f32 text_measure(const Font_Atlas& a, std::string_view text, f32 scale) {
+    f32 width = 0.0f;
+    for (char c : text) {
+        width += text_get_glyph(a, c).advance;
+    }
+    return width * scale;
+}
+
+f32 text_line_height(const Font_Atlas& a, f32 scale) {
+    return a.line_height * scale;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <string_view>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <SDL3_ttf/SDL_ttf.h>
+
+#include "number_types.h"
+
+// printable ascii, everything else is drawn as '?'
+const u32 TEXT_GLYPH_FIRST = 32;
+const u32 TEXT_GLYPH_LAST  = 126;
+const u32 TEXT_GLYPH_COUNT = TEXT_GLYPH_LAST - TEXT_GLYPH_FIRST + 1;
+
+struct Glyph {
+    // where the glyph is in the atlas texture
+    SDL_FRect src;
+    f32       advance;
+};
+
+// Every glyph of a font rasterized once into a single white texture,
+// the color comes from the vertices when drawing.
+struct Font_Atlas {
+    SDL_Texture*                        texture;
+    f32                                 width;
+    f32                                 height;
+    f32                                 line_height;
+    std::array<Glyph, TEXT_GLYPH_COUNT> glyphs;
+};
+
+// Has to be called after initializing the renderer.
+//
+// returns false on error
+bool text_atlas_init(Font_Atlas& a, SDL_Renderer* r, TTF_Font* font);
+
+// Quads of any amount of strings that get drawn with a single draw call.
+// Keep it around and only rebuild it when the text changes.
+struct Text_Batch {
+    const Font_Atlas*       atlas = nullptr;
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int>        indices;
+};
+
+struct Text_Opts {
+    // top left corner of the first glyph
+    f32        x;
+    f32        y;
+    // glyphs are rasterized at the font size, this scales them to the logical resolution
+    f32        scale = 1.0f;
+    SDL_FColor color = {0.0f, 0.0f, 0.0f, 1.0f};
+};
+
+void text_batch_clear(Text_Batch& b);
+// returns the width of the added text
+f32  text_batch_add(Text_Batch& b, std::string_view text, Text_Opts opts);
+void text_batch_draw(const Text_Batch& b, SDL_Renderer* r);
+
+f32 text_measure(const Font_Atlas& a, std::string_view text, f32 scale = 1.0f);
+f32 text_line_height(const Font_Atlas& a, f32 scale = 1.0f);
@@ -0,0 +1,139 @@
+// Packs every file under the asset directory into a single file that the game maps into memory,
+// see src/asset_pack.h for the layout. PNGs are decoded here so that the game doesnt have to.
+//
+// usage: asset-pack-builder <assets dir> <output>
+//
+// Run it from the directory that the game runs from, the paths in the index are the
+// ones that the game loads the loose files with.
+//
+// exit codes: 0 success, 1 error
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+
+#include "../src/number_types.h"
+#include "../src/asset_pack.h"
+
+namespace fs = std::filesystem;
+
+struct Pack_Item {
+    Asset_Pack_Entry entry;
+    std::vector<u8>  data;
+};
+
+static bool read_file(const fs::path& path, std::vector<u8>& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    out.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// rgba rows without padding, whatever the format of the png was
+static bool decode_png(const fs::path& path, Asset_Pack_Entry& entry, std::vector<u8>& out) {
+    SDL_Surface* loaded = IMG_Load(path.string().c_str());
+    if (!loaded) return false;
+    SDL_Surface* converted = SDL_ConvertSurface(loaded, ASSET_PACK_PIXEL_FORMAT);
+    SDL_DestroySurface(loaded);
+    if (!converted) return false;
+
+    const usize row_size = (usize)converted->w * 4;
+    out.resize(row_size * converted->h);
+    for (int row = 0; row < converted->h; row++) {
+        std::memcpy(out.data() + row * row_size, (const u8*)converted->pixels + row * converted->pitch, row_size);
+    }
+
+    entry.kind   = Asset_Kind::Pixels;
+    entry.width  = (u32)converted->w;
+    entry.height = (u32)converted->h;
+    SDL_DestroySurface(converted);
+    return true;
+}
+
+static u64 align_up(u64 value) {
+    return (value + ASSET_PACK_ALIGNMENT - 1) / ASSET_PACK_ALIGNMENT * ASSET_PACK_ALIGNMENT;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::fprintf(stderr, "usage: asset-pack-builder <assets dir> <output>\n");
+        return 1;
+    }
+    const fs::path dir_assets = argv[1];
+    const fs::path path_out   = argv[2];
+
+    std::vector<Pack_Item> items;
+    std::error_code err;
+    for (const auto& file : fs::recursive_directory_iterator(dir_assets, err)) {
+        if (!file.is_regular_file()) continue;
+
+        Pack_Item item = {};
+        const std::string path = file.path().generic_string();
+        if (path.size() >= ASSET_PACK_PATH_CAPACITY) {
+            std::fprintf(stderr, "path too long for the pack: %s\n", path.c_str());
+            return 1;
+        }
+        std::memcpy(item.entry.path, path.c_str(), path.size());
+
+        bool ok;
+        if (file.path().extension() == ".png") {
+            ok = decode_png(file.path(), item.entry, item.data);
+        } else {
+            item.entry.kind = Asset_Kind::Raw;
+            ok = read_file(file.path(), item.data);
+        }
+        if (!ok) {
+            std::fprintf(stderr, "could not read %s: %s\n", path.c_str(), SDL_GetError());
+            return 1;
+        }
+        item.entry.size = item.data.size();
+        items.push_back(std::move(item));
+    }
+    if (err) {
+        std::fprintf(stderr, "could not walk %s: %s\n", dir_assets.string().c_str(), err.message().c_str());
+        return 1;
+    }
+
+    // the game binary searches the index
+    std::sort(items.begin(), items.end(), [](const Pack_Item& a, const Pack_Item& b) {
+        return std::strcmp(a.entry.path, b.entry.path) < 0;
+    });
+
+    u64 offset = align_up(sizeof(Asset_Pack_Header) + items.size() * sizeof(Asset_Pack_Entry));
+    for (auto& item : items) {
+        item.entry.offset = offset;
+        offset = align_up(offset + item.entry.size);
+    }
+
+    std::ofstream out(path_out, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::fprintf(stderr, "could not open %s for writing\n", path_out.string().c_str());
+        return 1;
+    }
+
+    const Asset_Pack_Header header = {ASSET_PACK_MAGIC, ASSET_PACK_VERSION, (u32)items.size(), 0};
+    out.write((const char*)&header, sizeof(header));
+    for (const auto& item : items) out.write((const char*)&item.entry, sizeof(item.entry));
+
+    static const char padding[ASSET_PACK_ALIGNMENT] = {};
+    for (const auto& item : items) {
+        const u64 pos = (u64)out.tellp();
+        out.write(padding, item.entry.offset - pos);
+        out.write((const char*)item.data.data(), item.data.size());
+    }
+
+    if (!out) {
+        std::fprintf(stderr, "could not write %s\n", path_out.string().c_str());
+        return 1;
+    }
+
+    std::printf("packed %zu assets into %s (%llu bytes)\n", items.size(), path_out.string().c_str(), (unsigned long long)out.tellp());
+    return 0;
+}
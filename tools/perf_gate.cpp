@@ -0,0 +1,309 @@
+// Runs the game headless over a fixed set of scenarios and compares the
+// collected frame stats with a committed baseline.
+//
+// usage: perf-gate --game <path> [--baseline <path>] [--frames <n>]
+//                  [--threshold <metric>=<ratio>]... [--update-baseline]
+//
+// exit codes: 0 everything within thresholds, 1 regression, 2 usage or run error or a metric
+//             without a baseline, an unrecorded scenario must not pass the gate
+
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "../src/number_types.h"
+
+static constexpr const char* scenarios[] = {
+    "default",
+    "stress-100",
+    "stress-1000",
+};
+
+// every metric that gets compared, with the default allowed ratio over the baseline
+struct Metric {
+    const char* name;
+    f64         default_threshold;
+};
+
+static constexpr Metric metrics[] = {
+    {"frame_ms_p50",         1.25},
+    {"frame_ms_p95",         1.35},
+    {"frame_ms_p99",         1.50},
+    {"allocs_per_frame",     1.10},
+    {"draw_calls_per_frame", 1.00},
+};
+
+static constexpr u64 scenario_seed = 1;
+
+// Flattened json, nested object keys are joined with '.' and only numbers are kept,
+// which is all the bench reports and the baseline consist of.
+using Json_Numbers = std::map<std::string, f64>;
+
+struct Json_Parser {
+    const char* curr;
+    bool        ok = true;
+};
+
+static void json_skip_ws(Json_Parser& p) {
+    while (*p.curr && std::isspace((unsigned char)*p.curr)) p.curr++;
+}
+
+static bool json_expect(Json_Parser& p, char c) {
+    json_skip_ws(p);
+    if (*p.curr != c) {
+        p.ok = false;
+        return false;
+    }
+    p.curr++;
+    return true;
+}
+
+static std::string json_parse_string(Json_Parser& p) {
+    std::string result;
+    if (!json_expect(p, '"')) return result;
+
+    while (*p.curr && *p.curr != '"') {
+        if (*p.curr == '\\' && p.curr[1]) p.curr++;
+        result.push_back(*p.curr);
+        p.curr++;
+    }
+
+    json_expect(p, '"');
+    return result;
+}
+
+static void json_parse_value(Json_Parser& p, const std::string& key, Json_Numbers& out);
+
+static void json_parse_object(Json_Parser& p, const std::string& prefix, Json_Numbers& out) {
+    if (!json_expect(p, '{')) return;
+
+    json_skip_ws(p);
+    if (*p.curr == '}') {
+        p.curr++;
+        return;
+    }
+
+    while (p.ok) {
+        const auto key = json_parse_string(p);
+        if (!json_expect(p, ':')) return;
+        json_parse_value(p, prefix.empty() ? key : prefix + "." + key, out);
+
+        json_skip_ws(p);
+        if (*p.curr == ',') {
+            p.curr++;
+        } else {
+            json_expect(p, '}');
+            return;
+        }
+    }
+}
+
+static void json_parse_value(Json_Parser& p, const std::string& key, Json_Numbers& out) {
+    json_skip_ws(p);
+
+    if (*p.curr == '{') {
+        json_parse_object(p, key, out);
+    } else if (*p.curr == '"') {
+        json_parse_string(p);
+    } else {
+        char* end = nullptr;
+        const auto value = std::strtod(p.curr, &end);
+        if (end == p.curr) {
+            p.ok = false;
+            return;
+        }
+        out[key] = value;
+        p.curr = end;
+    }
+}
+
+static bool json_load_numbers(const std::filesystem::path& path, Json_Numbers& out) {
+    std::ifstream file(path);
+    if (!file) return false;
+
+    std::stringstream content;
+    content << file.rdbuf();
+    const auto str = content.str();
+
+    Json_Parser p = { .curr = str.c_str() };
+    json_parse_object(p, "", out);
+    return p.ok;
+}
+
+struct Gate_Opts {
+    std::string game_path;
+    std::string baseline_path = "tools/perf_baseline.json";
+    u32         frames        = 600;
+    bool        update        = false;
+    // overrides of the thresholds stored in the baseline
+    std::map<std::string, f64> thresholds;
+};
+
+static bool gate_parse_args(Gate_Opts& opts, int argc, char** argv) {
+    for (int idx = 1; idx < argc; idx++) {
+        const char* arg = argv[idx];
+        const char* value = (idx + 1 < argc) ? argv[idx + 1] : nullptr;
+
+        if (std::strcmp(arg, "--update-baseline") == 0) {
+            opts.update = true;
+        } else if (std::strcmp(arg, "--game") == 0 && value) {
+            opts.game_path = value;
+            idx++;
+        } else if (std::strcmp(arg, "--baseline") == 0 && value) {
+            opts.baseline_path = value;
+            idx++;
+        } else if (std::strcmp(arg, "--frames") == 0 && value) {
+            opts.frames = (u32)std::strtoul(value, nullptr, 10);
+            idx++;
+        } else if (std::strcmp(arg, "--threshold") == 0 && value) {
+            const char* eq = std::strchr(value, '=');
+            if (!eq) {
+                std::fprintf(stderr, "threshold has to be given as <metric>=<ratio>, got '%s'\n", value);
+                return false;
+            }
+            opts.thresholds[std::string(value, eq)] = std::strtod(eq + 1, nullptr);
+            idx++;
+        } else {
+            std::fprintf(stderr, "unknown argument '%s'\n", arg);
+            return false;
+        }
+    }
+
+    if (opts.game_path.empty() || opts.frames == 0) {
+        std::fprintf(stderr, "usage: perf-gate --game <path> [--baseline <path>] [--frames <n>] [--threshold <metric>=<ratio>]... [--update-baseline]\n");
+        return false;
+    }
+
+    return true;
+}
+
+static bool run_scenario(const Gate_Opts& opts, const char* scenario, Json_Numbers& report) {
+    const auto report_path = std::filesystem::temp_directory_path() / (std::string("perf_gate_") + scenario + ".json");
+    std::filesystem::remove(report_path);
+
+    std::stringstream cmd;
+    cmd << '"' << opts.game_path << '"'
+        << " --headless"
+        << " --scenario "  << scenario
+        << " --seed "      << scenario_seed
+        << " --bench "     << opts.frames
+        << " --bench-out " << '"' << report_path.string() << '"';
+
+    std::printf("running %s\n", cmd.str().c_str());
+    std::fflush(stdout);
+    if (std::system(cmd.str().c_str()) != 0) {
+        std::fprintf(stderr, "scenario '%s' failed to run\n", scenario);
+        return false;
+    }
+
+    if (!json_load_numbers(report_path, report)) {
+        std::fprintf(stderr, "could not read the report of scenario '%s' from %s\n", scenario, report_path.string().c_str());
+        return false;
+    }
+
+    return true;
+}
+
+static f64 gate_threshold(const Gate_Opts& opts, const Json_Numbers& baseline, const Metric& metric) {
+    if (auto it = opts.thresholds.find(metric.name); it != opts.thresholds.end()) return it->second;
+    if (auto it = baseline.find(std::string("thresholds.") + metric.name); it != baseline.end()) return it->second;
+    return metric.default_threshold;
+}
+
+static bool write_baseline(const Gate_Opts& opts, const Json_Numbers& baseline, const std::map<std::string, Json_Numbers>& reports) {
+    std::ofstream out(opts.baseline_path);
+    if (!out) return false;
+
+    out << "{\n    \"thresholds\": {\n";
+    for (usize idx = 0; idx < std::size(metrics); idx++) {
+        out << "        \"" << metrics[idx].name << "\": " << gate_threshold(opts, baseline, metrics[idx])
+            << (idx + 1 < std::size(metrics) ? ",\n" : "\n");
+    }
+    out << "    },\n    \"scenarios\": {\n";
+
+    usize scenario_idx = 0;
+    for (const auto& [scenario, report] : reports) {
+        out << "        \"" << scenario << "\": {\n";
+        for (usize idx = 0; idx < std::size(metrics); idx++) {
+            const auto it = report.find(metrics[idx].name);
+            out << "            \"" << metrics[idx].name << "\": " << (it != report.end() ? it->second : 0.0)
+                << (idx + 1 < std::size(metrics) ? ",\n" : "\n");
+        }
+        out << "        }" << (++scenario_idx < reports.size() ? ",\n" : "\n");
+    }
+    out << "    }\n}\n";
+
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Gate_Opts opts = {};
+    if (!gate_parse_args(opts, argc, argv)) return 2;
+
+    Json_Numbers baseline;
+    if (!json_load_numbers(opts.baseline_path, baseline) && !opts.update) {
+        std::fprintf(stderr, "could not read baseline %s\n", opts.baseline_path.c_str());
+        return 2;
+    }
+
+    std::map<std::string, Json_Numbers> reports;
+    for (const char* scenario : scenarios) {
+        if (!run_scenario(opts, scenario, reports[scenario])) return 2;
+    }
+
+    if (opts.update) {
+        if (!write_baseline(opts, baseline, reports)) {
+            std::fprintf(stderr, "could not write baseline %s\n", opts.baseline_path.c_str());
+            return 2;
+        }
+        std::printf("baseline written to %s\n", opts.baseline_path.c_str());
+        return 0;
+    }
+
+    bool regressed = false;
+    bool missing   = false;
+    std::printf("\n%-14s %-22s %12s %12s %8s %8s\n", "scenario", "metric", "baseline", "current", "ratio", "limit");
+    for (const char* scenario : scenarios) {
+        const auto& report = reports[scenario];
+
+        for (const auto& metric : metrics) {
+            const auto key_baseline = std::string("scenarios.") + scenario + "." + metric.name;
+            const auto it_baseline  = baseline.find(key_baseline);
+            const auto it_current   = report.find(metric.name);
+            const auto current      = it_current != report.end() ? it_current->second : 0.0;
+
+            if (it_baseline == baseline.end()) {
+                std::printf("%-14s %-22s %12s %12.4f %8s %8s  NO BASELINE\n", scenario, metric.name, "-", current, "-", "-");
+                missing = true;
+                continue;
+            }
+
+            const auto limit = gate_threshold(opts, baseline, metric);
+            const auto base  = it_baseline->second;
+            const auto ratio = base > 0.0 ? current / base : (current > 0.0 ? INFINITY : 1.0);
+            const auto over  = ratio > limit;
+            regressed |= over;
+
+            std::printf("%-14s %-22s %12.4f %12.4f %8.3f %8.3f%s\n", scenario, metric.name, base, current, ratio, limit, over ? "  REGRESSION" : "");
+        }
+    }
+
+    if (regressed) {
+        std::fprintf(stderr, "\nperformance regressed beyond the allowed thresholds\n");
+        return 1;
+    }
+    if (missing) {
+        std::fprintf(stderr, "\nthe baseline %s misses metrics, record them with --update-baseline\n", opts.baseline_path.c_str());
+        return 2;
+    }
+
+    std::printf("\nall metrics within thresholds\n");
+    return 0;
+}